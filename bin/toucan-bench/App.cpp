@@ -0,0 +1,546 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "App.h"
+
+#include <toucanRender/ImagePlan.h>
+#include <toucanRender/MediaPool.h>
+#include <toucanRender/PropertySet.h>
+#include <toucanRender/Read.h>
+#include <toucanRender/Util.h>
+
+#include <opentimelineio/clip.h>
+#include <opentimelineio/generatorReference.h>
+
+#include <OpenFX/ofxImageEffect.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#if defined(_WINDOWS)
+#include <windows.h>
+#include <psapi.h>
+#else // _WINDOWS
+#include <sys/resource.h>
+#endif // _WINDOWS
+
+namespace toucan
+{
+    namespace
+    {
+        double seconds(const std::chrono::steady_clock::time_point& t0)
+        {
+            const std::chrono::duration<double> diff =
+                std::chrono::steady_clock::now() - t0;
+            return diff.count();
+        }
+
+        double percentile(const std::vector<double>& sorted, double value)
+        {
+            double out = 0.0;
+            if (!sorted.empty())
+            {
+                size_t index = static_cast<size_t>(std::ceil(value * sorted.size()));
+                if (index > 0)
+                {
+                    --index;
+                }
+                out = sorted[std::min(index, sorted.size() - 1)];
+            }
+            return out;
+        }
+
+        nlohmann::json stats(const std::vector<double>& values)
+        {
+            double total = 0.0;
+            for (const double value : values)
+            {
+                total += value;
+            }
+            std::vector<double> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            nlohmann::json out;
+            out["total"] = total;
+            out["mean"] = !values.empty() ? (total / values.size()) : 0.0;
+            out["p50"] = percentile(sorted, .5);
+            out["p95"] = percentile(sorted, .95);
+            out["p99"] = percentile(sorted, .99);
+            out["max"] = !sorted.empty() ? sorted.back() : 0.0;
+            return out;
+        }
+
+        //! Get the peak resident set size of the process in bytes.
+        size_t getPeakRSS()
+        {
+            size_t out = 0;
+#if defined(_WINDOWS)
+            PROCESS_MEMORY_COUNTERS counters;
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            {
+                out = counters.PeakWorkingSetSize;
+            }
+#else // _WINDOWS
+            struct rusage usage;
+            if (0 == getrusage(RUSAGE_SELF, &usage))
+            {
+#if defined(__APPLE__)
+                out = usage.ru_maxrss;
+#else // __APPLE__
+                out = usage.ru_maxrss * 1024;
+#endif // __APPLE__
+            }
+#endif // _WINDOWS
+            return out;
+        }
+
+        //! Property set with the previous layout of a map of strings for
+        //! each type, used as the baseline for the property benchmark.
+        class MapPropertySet
+        {
+        public:
+            OfxStatus setPointer(const char* property, int index, void* value)
+            {
+                return _set(_p, property, index, value);
+            }
+
+            OfxStatus setString(const char* property, int index, const char* value)
+            {
+                return _set(_s, property, index, std::string(value));
+            }
+
+            OfxStatus setDouble(const char* property, int index, double value)
+            {
+                return _set(_d, property, index, value);
+            }
+
+            OfxStatus setIntN(const char* property, int count, const int* value)
+            {
+                _i[property] = std::vector<int>(value, value + count);
+                return kOfxStatOK;
+            }
+
+            OfxStatus getPointer(const char* property, int index, void** value) const
+            {
+                return _get(_p, property, index, value);
+            }
+
+            OfxStatus getString(const char* property, int index, char** value) const
+            {
+                const auto i = _s.find(property);
+                if (i != _s.end() && index < i->second.size())
+                {
+                    *value = const_cast<char*>(i->second[index].c_str());
+                    return kOfxStatOK;
+                }
+                return kOfxStatFailed;
+            }
+
+            OfxStatus getDouble(const char* property, int index, double* value) const
+            {
+                return _get(_d, property, index, value);
+            }
+
+            OfxStatus getIntN(const char* property, int count, int* value) const
+            {
+                const auto i = _i.find(property);
+                if (i != _i.end() && count == i->second.size())
+                {
+                    std::copy(i->second.begin(), i->second.end(), value);
+                    return kOfxStatOK;
+                }
+                return kOfxStatFailed;
+            }
+
+        private:
+            template<typename T>
+            static OfxStatus _set(
+                std::map<std::string, std::vector<T> >& map,
+                const char* property,
+                int index,
+                const T& value)
+            {
+                auto& v = map[property];
+                if (index >= v.size())
+                {
+                    v.resize(index + 1);
+                }
+                v[index] = value;
+                return kOfxStatOK;
+            }
+
+            template<typename T>
+            static OfxStatus _get(
+                const std::map<std::string, std::vector<T> >& map,
+                const char* property,
+                int index,
+                T* value)
+            {
+                const auto i = map.find(property);
+                if (i != map.end() && index < i->second.size())
+                {
+                    *value = i->second[index];
+                    return kOfxStatOK;
+                }
+                return kOfxStatFailed;
+            }
+
+            std::map<std::string, std::vector<void*> > _p;
+            std::map<std::string, std::vector<std::string> > _s;
+            std::map<std::string, std::vector<double> > _d;
+            std::map<std::string, std::vector<int> > _i;
+        };
+
+        //! Get the average time in nanoseconds of the property set calls
+        //! made for one render: the host fills in the render arguments and
+        //! the image properties, and the plugin reads them back.
+        template<typename T>
+        double benchPropertySet(int iterations)
+        {
+            int bounds[4] = { 0, 0, 1920, 1080 };
+            int window[4] = { 0, 0, 0, 0 };
+            double time = 0.0;
+            char* components = nullptr;
+            char* pixelDepth = nullptr;
+            void* data = nullptr;
+            size_t check = 0;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                T args;
+                args.setDouble(kOfxPropTime, 0, i);
+                args.setIntN(kOfxImageEffectPropRenderWindow, 4, bounds);
+                args.setString(kOfxImageEffectPropFieldToRender, 0, kOfxImageFieldNone);
+
+                T image;
+                image.setIntN(kOfxImagePropBounds, 4, bounds);
+                image.setString(kOfxImageEffectPropComponents, 0, kOfxImageComponentRGBA);
+                image.setString(kOfxImageEffectPropPixelDepth, 0, kOfxBitDepthFloat);
+                image.setPointer(kOfxImagePropData, 0, &check);
+
+                args.getDouble(kOfxPropTime, 0, &time);
+                args.getIntN(kOfxImageEffectPropRenderWindow, 4, window);
+                image.getIntN(kOfxImagePropBounds, 4, bounds);
+                image.getString(kOfxImageEffectPropComponents, 0, &components);
+                image.getString(kOfxImageEffectPropPixelDepth, 0, &pixelDepth);
+                image.getPointer(kOfxImagePropData, 0, &data);
+                check += window[2] + (components ? components[0] : 0) + (data ? 1 : 0);
+            }
+            const double out = seconds(t0) * 1000000000.0 / iterations;
+            return check > 0 ? out : 0.0;
+        }
+
+        //! Get the time spent executing the read nodes in a graph.
+        double getReadTime(const std::shared_ptr<IImageNode>& node)
+        {
+            double out = 0.0;
+            std::set<IImageNode*> visited;
+            std::vector<IImageNode*> stack = { node.get() };
+            while (!stack.empty())
+            {
+                IImageNode* node = stack.back();
+                stack.pop_back();
+                if (visited.insert(node).second)
+                {
+                    if (dynamic_cast<ReadFrameNode*>(node) || dynamic_cast<IReadNode*>(node))
+                    {
+                        out += node->getExecTime();
+                    }
+                    for (const auto& input : node->getInputs())
+                    {
+                        if (input)
+                        {
+                            stack.push_back(input.get());
+                        }
+                    }
+                }
+            }
+            return out;
+        }
+    }
+
+    void App::_init(
+        const std::shared_ptr<ftk::Context>& context,
+        std::vector<std::string>& argv)
+    {
+        _cmdLine.input = ftk::CmdLineValueArg<std::string>::create(
+            "input",
+            "Input .otio file, or a directory of .otio files.");
+
+        _cmdLine.json = ftk::CmdLineValueOption<std::string>::create(
+            std::vector<std::string>{ "-json" },
+            "Write the results to a JSON file instead of stdout.");
+        _cmdLine.tracks = ftk::CmdLineValueOption<int>::create(
+            std::vector<std::string>{ "-tracks" },
+            "Scale the timeline by stacking copies of the video tracks.",
+            "",
+            1);
+        _cmdLine.size = ftk::CmdLineValueOption<std::string>::create(
+            std::vector<std::string>{ "-size" },
+            "Override the size of generators, for example 3840x2160.");
+        _cmdLine.frames = ftk::CmdLineValueOption<int>::create(
+            std::vector<std::string>{ "-frames" },
+            "Number of frames to render. The timeline is looped if this is longer than the timeline duration.");
+        _cmdLine.readAhead = ftk::CmdLineValueOption<int>::create(
+            std::vector<std::string>{ "-read_ahead" },
+            "Number of frames to read ahead in the background.",
+            "",
+            8);
+        _cmdLine.cache = ftk::CmdLineValueOption<int>::create(
+            std::vector<std::string>{ "-cache" },
+            "Image cache size in megabytes. The cache is disabled by default so that every frame is rendered.",
+            "",
+            0);
+
+        IApp::_init(
+            context,
+            argv,
+            "toucan-bench",
+            "Measure the rendering performance of timeline files",
+            { _cmdLine.input },
+            {
+                _cmdLine.json,
+                _cmdLine.tracks,
+                _cmdLine.size,
+                _cmdLine.frames,
+                _cmdLine.readAhead,
+                _cmdLine.cache
+            });
+    }
+
+    App::App()
+    {}
+
+    App::~App()
+    {}
+
+    std::shared_ptr<App> App::create(
+        const std::shared_ptr<ftk::Context>& context,
+        std::vector<std::string>& argv)
+    {
+        auto out = std::shared_ptr<App>(new App);
+        out->_init(context, argv);
+        return out;
+    }
+
+    void App::run()
+    {
+        const std::filesystem::path inputPath(_cmdLine.input->getValue());
+        const bool printProgress = _cmdLine.json->hasValue();
+
+        // Find the timeline files.
+        std::vector<std::filesystem::path> paths;
+        if (std::filesystem::is_directory(inputPath) &&
+            toLower(inputPath.extension().string()) != ".otiod")
+        {
+            for (const auto& entry : std::filesystem::directory_iterator(inputPath))
+            {
+                const std::string extension = toLower(entry.path().extension().string());
+                if (".otio" == extension || ".otiod" == extension || ".otioz" == extension)
+                {
+                    paths.push_back(entry.path());
+                }
+            }
+            std::sort(paths.begin(), paths.end());
+        }
+        else
+        {
+            paths.push_back(inputPath);
+        }
+
+        // Create the image host.
+        _host = std::make_shared<ImageEffectHost>(_context, getOpenFXPluginPaths(getExeName()));
+
+        // Run the benchmarks.
+        nlohmann::json json;
+        json["tracks"] = _cmdLine.tracks->hasValue() ? _cmdLine.tracks->getValue() : 1;
+        if (_cmdLine.size->hasValue())
+        {
+            json["size"] = _cmdLine.size->getValue();
+        }
+        nlohmann::json results = nlohmann::json::array();
+        for (const auto& path : paths)
+        {
+            if (printProgress)
+            {
+                std::cout << path.filename().string() << std::endl;
+            }
+            nlohmann::json result;
+            try
+            {
+                result = _bench(path);
+            }
+            catch (const std::exception& e)
+            {
+                result["file"] = path.filename().string();
+                result["error"] = e.what();
+            }
+            if (printProgress && result.contains("fps"))
+            {
+                std::cout << "  " << result["fps"].get<double>() << " frames/sec" << std::endl;
+            }
+            results.push_back(result);
+        }
+        json["results"] = results;
+        const int propertyIterations = 100000;
+        json["propertySet"] =
+        {
+            { "map", benchPropertySet<MapPropertySet>(propertyIterations) },
+            { "flat", benchPropertySet<PropertySet>(propertyIterations) }
+        };
+        json["peakRSS"] = getPeakRSS();
+        const MediaPoolStats mediaPoolStats = MediaPool::get()->getStats();
+        json["mediaPool"] =
+        {
+            { "hits", mediaPoolStats.hits },
+            { "misses", mediaPoolStats.misses },
+            { "evictions", mediaPoolStats.evictions }
+        };
+
+        // Write the results.
+        if (_cmdLine.json->hasValue())
+        {
+            std::ofstream file(_cmdLine.json->getValue());
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Cannot open file: " + _cmdLine.json->getValue());
+            }
+            file << json.dump(4) << std::endl;
+        }
+        else
+        {
+            std::cout << json.dump(4) << std::endl;
+        }
+    }
+
+    nlohmann::json App::_bench(const std::filesystem::path& path)
+    {
+        nlohmann::json out;
+        out["file"] = path.filename().string();
+
+        // Open the timeline.
+        auto t0 = std::chrono::steady_clock::now();
+        auto timelineWrapper = std::make_shared<TimelineWrapper>(path);
+        _scale(timelineWrapper);
+        out["open"] = seconds(t0);
+
+        // Get time values.
+        const OTIO_NS::TimeRange& timeRange = timelineWrapper->getTimeRange();
+        const double rate = timeRange.duration().rate();
+        const int64_t duration = timeRange.duration().value();
+        const int64_t frames = _cmdLine.frames->hasValue() ?
+            _cmdLine.frames->getValue() :
+            duration;
+
+        // Create the image graph.
+        auto graph = std::make_shared<ImageGraph>(
+            _context,
+            path.parent_path(),
+            timelineWrapper);
+        const int cacheSize = _cmdLine.cache->hasValue() ? _cmdLine.cache->getValue() : 0;
+        graph->setImageCache(cacheSize > 0 ?
+            std::make_shared<ImageCache>(static_cast<size_t>(cacheSize) * 1024 * 1024) :
+            nullptr);
+        graph->setReadAhead(_cmdLine.readAhead->hasValue() ? _cmdLine.readAhead->getValue() : 0);
+        const IMATH_NAMESPACE::V2i& imageSize = graph->getImageSize();
+        out["imageSize"] = { imageSize.x, imageSize.y };
+        out["rate"] = rate;
+
+        // Render the frames. The build time is the time to create the
+        // image graph, the execute time is the time to render the image,
+        // and the I/O time is the part of the execute time spent in read
+        // nodes.
+        std::vector<double> buildTimes;
+        std::vector<double> execTimes;
+        std::vector<double> ioTimes;
+        std::vector<double> frameTimes;
+        size_t planPeakMemory = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (int64_t frame = 0; frame < frames && duration > 0; ++frame)
+        {
+            const OTIO_NS::RationalTime time =
+                timeRange.start_time() +
+                OTIO_NS::RationalTime(static_cast<double>(frame % duration), rate);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            auto node = graph->exec(_host, time);
+            const double buildTime = seconds(t1);
+
+            double execTime = 0.0;
+            double ioTime = 0.0;
+            if (node)
+            {
+                const auto t2 = std::chrono::steady_clock::now();
+                const auto buf = node->exec();
+                execTime = seconds(t2);
+                ioTime = getReadTime(node);
+                planPeakMemory = std::max(
+                    planPeakMemory,
+                    ImagePlan(node, graph->getImageSpec()).getPeakMemory());
+            }
+
+            buildTimes.push_back(buildTime);
+            execTimes.push_back(execTime);
+            ioTimes.push_back(ioTime);
+            frameTimes.push_back(buildTime + execTime);
+        }
+        const double totalTime = seconds(t0);
+
+        out["frames"] = frames;
+        out["seconds"] = totalTime;
+        out["fps"] = totalTime > 0.0 ? (frames / totalTime) : 0.0;
+        out["build"] = stats(buildTimes);
+        out["exec"] = stats(execTimes);
+        out["io"] = stats(ioTimes);
+        out["latency"] = stats(frameTimes);
+        out["peakRSS"] = getPeakRSS();
+        out["planPeakMemory"] = planPeakMemory;
+        return out;
+    }
+
+    void App::_scale(const std::shared_ptr<TimelineWrapper>& timelineWrapper)
+    {
+        const auto& timeline = timelineWrapper->getTimeline();
+
+        // Stack copies of the video tracks.
+        const int tracks = _cmdLine.tracks->hasValue() ? _cmdLine.tracks->getValue() : 1;
+        if (tracks > 1)
+        {
+            const auto videoTracks = timeline->video_tracks();
+            for (int i = 1; i < tracks; ++i)
+            {
+                for (const auto& track : videoTracks)
+                {
+                    if (auto clone = dynamic_cast<OTIO_NS::Track*>(track->clone()))
+                    {
+                        timeline->tracks()->append_child(clone);
+                    }
+                }
+            }
+        }
+
+        // Override the generator sizes.
+        if (_cmdLine.size->hasValue())
+        {
+            IMATH_NAMESPACE::V2i size;
+            char x = 0;
+            std::stringstream ss(_cmdLine.size->getValue());
+            ss >> size.x >> x >> size.y;
+            if (ss.fail() || size.x <= 0 || size.y <= 0)
+            {
+                throw std::runtime_error("Cannot parse size: " + _cmdLine.size->getValue());
+            }
+            for (const auto& clip : timeline->find_clips())
+            {
+                if (auto generatorRef = dynamic_cast<OTIO_NS::GeneratorReference*>(clip->media_reference()))
+                {
+                    generatorRef->parameters()["size"] = vecToAny(size);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <toucanRender/ImageEffectHost.h>
+#include <toucanRender/ImageGraph.h>
+#include <toucanRender/TimelineWrapper.h>
+
+#include <ftk/Core/CmdLine.h>
+#include <ftk/Core/IApp.h>
+
+#include <nlohmann/json.hpp>
+
+namespace toucan
+{
+    class App : public ftk::IApp
+    {
+    protected:
+        void _init(
+            const std::shared_ptr<ftk::Context>&,
+            std::vector<std::string>&);
+
+        App();
+
+    public:
+        ~App();
+
+        static std::shared_ptr<App> create(
+            const std::shared_ptr<ftk::Context>&,
+            std::vector<std::string>&);
+
+        void run() override;
+
+    private:
+        nlohmann::json _bench(const std::filesystem::path&);
+
+        void _scale(const std::shared_ptr<TimelineWrapper>&);
+
+        struct CmdLine
+        {
+            std::shared_ptr<ftk::CmdLineValueArg<std::string> > input;
+
+            std::shared_ptr<ftk::CmdLineValueOption<std::string> > json;
+            std::shared_ptr<ftk::CmdLineValueOption<int> > tracks;
+            std::shared_ptr<ftk::CmdLineValueOption<std::string> > size;
+            std::shared_ptr<ftk::CmdLineValueOption<int> > frames;
+            std::shared_ptr<ftk::CmdLineValueOption<int> > readAhead;
+            std::shared_ptr<ftk::CmdLineValueOption<int> > cache;
+        };
+        CmdLine _cmdLine;
+
+        std::shared_ptr<ImageEffectHost> _host;
+    };
+}
@@ -40,8 +40,8 @@ namespace toucan
         };
         CmdLine _cmdLine;
 
+        std::shared_ptr<ImageEffectHost> _host;
         std::shared_ptr<TimelineWrapper> _timelineWrapper;
         std::shared_ptr<ImageGraph> _graph;
-        std::shared_ptr<ImageEffectHost> _host;
     };
 }
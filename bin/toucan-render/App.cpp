@@ -4,6 +4,7 @@
 #include "App.h"
 
 #include <toucanRender/FFmpegWrite.h>
+#include <toucanRender/ImagePlan.h>
 #include <toucanRender/Read.h>
 #include <toucanRender/Util.h>
 
@@ -17,12 +18,19 @@ extern "C"
 
 } // extern "C"
 
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include <stdio.h>
 
 namespace toucan
 {
     namespace
     {
+        const size_t readAheadFrames = 8;
+
         const std::map<std::string, OIIO::ImageSpec> rawSpecs =
         {
             { "rgb24", OIIO::ImageSpec(0, 0, 3, OIIO::TypeDesc::BASETYPE::UINT8) },
@@ -94,6 +102,11 @@ namespace toucan
             "",
             std::optional<std::string>(),
             ftk::join(y4mList, ", "));
+        _cmdLine.threads = ftk::CmdLineValueOption<int>::create(
+            std::vector<std::string>{ "-threads" },
+            "Number of frames to render concurrently.",
+            "",
+            1);
         _cmdLine.verbose = ftk::CmdLineFlagOption::create(
             std::vector<std::string>{ "-v" },
             "Print verbose output.");
@@ -112,6 +125,7 @@ namespace toucan
                 _cmdLine.printSize,
                 _cmdLine.raw,
                 _cmdLine.y4m,
+                _cmdLine.threads,
                 _cmdLine.verbose
             });
 
@@ -219,22 +233,9 @@ namespace toucan
         {
             _writeY4mHeader();
         }
-        for (OTIO_NS::RationalTime time = timeRange.start_time();
-            time <= timeRange.end_time_inclusive();
-            time += timeInc)
-        {
-            if (!_cmdLine.outputRaw)
+        auto writeFrame = [this, &outputPath, &outputSplit, outputStartFrame, outputNumberPadding, ffWrite]
+            (const OIIO::ImageBuf& buf, const OTIO_NS::RationalTime& time)
             {
-                std::cout << (time - timeRange.start_time()).value() << "/" <<
-                    timeRange.duration().value() << std::endl;
-            }
-
-            if (auto node = _graph->exec(_host, time))
-            {
-                // Execute the graph.
-                const auto buf = node->exec();
-
-                // Save the image.
                 if (!_cmdLine.outputRaw)
                 {
                     if (ffWrite)
@@ -260,7 +261,213 @@ namespace toucan
                 {
                     _writeY4mFrame(buf);
                 }
+            };
+        const int threadCount = _cmdLine.threads->hasValue() ? _cmdLine.threads->getValue() : 1;
+        if (threadCount > 1)
+        {
+            _renderThreads(threadCount, inputPath, writeFrame);
+            return;
+        }
+
+        // Frames are rendered in order, so media can be read ahead
+        // while the previous frame is processed.
+        _graph->setReadAhead(readAheadFrames);
+        for (OTIO_NS::RationalTime time = timeRange.start_time();
+            time <= timeRange.end_time_inclusive();
+            time += timeInc)
+        {
+            if (!_cmdLine.outputRaw)
+            {
+                std::cout << (time - timeRange.start_time()).value() << "/" <<
+                    timeRange.duration().value() << std::endl;
             }
+
+            if (auto node = _graph->exec(_host, time))
+            {
+                // Execute the graph.
+                const auto buf = node->exec();
+
+                // Save the image.
+                writeFrame(buf, time);
+            }
+        }
+    }
+
+    void App::_renderThreads(
+        int threadCount,
+        const std::filesystem::path& inputPath,
+        const std::function<void(const OIIO::ImageBuf&, const OTIO_NS::RationalTime&)>& writeFrame)
+    {
+        const OTIO_NS::TimeRange& timeRange = _timelineWrapper->getTimeRange();
+        const int64_t frames = timeRange.duration().value();
+
+        // Frames are rendered out of order by the worker threads and
+        // collected in a reorder buffer, so they can be written in timeline
+        // order. The number of frames in flight is limited to bound the
+        // memory used by the buffer.
+        struct Frame
+        {
+            bool valid = false;
+            OIIO::ImageBuf buf;
+        };
+        struct Mutex
+        {
+            int64_t nextFrame = 0;
+            int64_t writeFrame = 0;
+            std::map<int64_t, Frame> frames;
+            bool cancelled = false;
+            std::exception_ptr error;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+        std::condition_variable cv;
+        const int64_t maxFramesInFlight = threadCount * 2;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; ++i)
+        {
+            threads.push_back(std::thread(
+                [this, &inputPath, &timeRange, frames, maxFramesInFlight, &mutex, &cv]
+                {
+                    try
+                    {
+                        // Each thread has its own image graph, so the read
+                        // nodes are not shared between threads.
+                        auto graph = std::make_shared<ImageGraph>(
+                            _context,
+                            inputPath.parent_path(),
+                            _timelineWrapper);
+                        graph->setImageCache(_graph->getImageCache());
+                        while (1)
+                        {
+                            int64_t frame = 0;
+                            {
+                                std::unique_lock<std::mutex> lock(mutex.mutex);
+                                cv.wait(
+                                    lock,
+                                    [&mutex, maxFramesInFlight]
+                                    {
+                                        return
+                                            mutex.cancelled ||
+                                            mutex.nextFrame - mutex.writeFrame < maxFramesInFlight;
+                                    });
+                                if (mutex.cancelled || mutex.nextFrame >= frames)
+                                {
+                                    break;
+                                }
+                                frame = mutex.nextFrame;
+                                ++mutex.nextFrame;
+                            }
+
+                            Frame out;
+                            const OTIO_NS::RationalTime time =
+                                timeRange.start_time() +
+                                OTIO_NS::RationalTime(frame, timeRange.duration().rate());
+                            if (auto node = graph->exec(_host, time))
+                            {
+                                // Execute the graph with a plan, so the
+                                // memory used by each thread is bounded by
+                                // the plan's peak memory.
+                                ImagePlan plan(node, graph->getImageSpec());
+                                out.valid = true;
+                                out.buf = plan.exec();
+                            }
+
+                            {
+                                std::unique_lock<std::mutex> lock(mutex.mutex);
+                                mutex.frames[frame] = std::move(out);
+                            }
+                            cv.notify_all();
+                        }
+                    }
+                    catch (const std::exception&)
+                    {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex.mutex);
+                            if (!mutex.error)
+                            {
+                                mutex.error = std::current_exception();
+                            }
+                            mutex.cancelled = true;
+                        }
+                        cv.notify_all();
+                    }
+                    catch (...)
+                    {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex.mutex);
+                            if (!mutex.error)
+                            {
+                                mutex.error = std::make_exception_ptr(
+                                    std::runtime_error("Unknown error rendering frame"));
+                            }
+                            mutex.cancelled = true;
+                        }
+                        cv.notify_all();
+                    }
+                }));
+        }
+
+        // Write the frames in order.
+        try
+        {
+            for (int64_t frame = 0; frame < frames; ++frame)
+            {
+                Frame out;
+                {
+                    std::unique_lock<std::mutex> lock(mutex.mutex);
+                    cv.wait(
+                        lock,
+                        [&mutex, frame]
+                        {
+                            return
+                                mutex.cancelled ||
+                                mutex.frames.find(frame) != mutex.frames.end();
+                        });
+                    const auto i = mutex.frames.find(frame);
+                    if (i == mutex.frames.end())
+                    {
+                        break;
+                    }
+                    out = std::move(i->second);
+                    mutex.frames.erase(i);
+                    mutex.writeFrame = frame + 1;
+                }
+                cv.notify_all();
+
+                const OTIO_NS::RationalTime time =
+                    timeRange.start_time() +
+                    OTIO_NS::RationalTime(frame, timeRange.duration().rate());
+                if (!_cmdLine.outputRaw)
+                {
+                    std::cout << frame << "/" << frames << std::endl;
+                }
+                if (out.valid)
+                {
+                    writeFrame(out.buf, time);
+                }
+            }
+        }
+        catch (...)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex.mutex);
+                if (!mutex.error)
+                {
+                    mutex.error = std::current_exception();
+                }
+                mutex.cancelled = true;
+            }
+            cv.notify_all();
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        if (mutex.error)
+        {
+            std::rethrow_exception(mutex.error);
         }
     }
 
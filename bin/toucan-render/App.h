@@ -12,6 +12,8 @@
 
 #include <OpenImageIO/imagebuf.h>
 
+#include <functional>
+
 extern "C"
 {
 #include <libswscale/swscale.h>
@@ -39,6 +41,11 @@ namespace toucan
         void run() override;
     
     private:
+        void _renderThreads(
+            int threadCount,
+            const std::filesystem::path&,
+            const std::function<void(const OIIO::ImageBuf&, const OTIO_NS::RationalTime&)>&);
+
         void _writeRawFrame(const OIIO::ImageBuf&);
         void _writeY4mHeader();
         void _writeY4mFrame(const OIIO::ImageBuf&);
@@ -56,13 +63,14 @@ namespace toucan
             std::shared_ptr<ftk::CmdLineFlagOption> printSize;
             std::shared_ptr<ftk::CmdLineValueOption<std::string> > raw;
             std::shared_ptr<ftk::CmdLineValueOption<std::string> > y4m;
+            std::shared_ptr<ftk::CmdLineValueOption<int> > threads;
             std::shared_ptr<ftk::CmdLineFlagOption> verbose;
         };
         CmdLine _cmdLine;
 
+        std::shared_ptr<ImageEffectHost> _host;
         std::shared_ptr<TimelineWrapper> _timelineWrapper;
         std::shared_ptr<ImageGraph> _graph;
-        std::shared_ptr<ImageEffectHost> _host;
 
         AVFrame* _avFrame = nullptr;
         AVFrame* _avFrame2 = nullptr;
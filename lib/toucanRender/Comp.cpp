@@ -3,12 +3,208 @@
 
 #include "Comp.h"
 
+#include "Constant.h"
 #include "Util.h"
 
 #include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imagebufalgo_util.h>
+#include <OpenImageIO/simd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 namespace toucan
 {
+    namespace
+    {
+        using OIIO::simd::vfloat4;
+        using OIIO::simd::vint4;
+
+        // Load a pixel and convert it to normalized floating point.
+        vfloat4 loadPixel(const uint8_t* p)
+        {
+            vfloat4 out;
+            out.load(p);
+            return out * (1.F / 255.F);
+        }
+
+        vfloat4 loadPixel(const uint16_t* p)
+        {
+            vfloat4 out;
+            out.load(p);
+            return out * (1.F / 65535.F);
+        }
+
+        vfloat4 loadPixel(const half* p)
+        {
+            vfloat4 out;
+            out.load(p);
+            return out;
+        }
+
+        vfloat4 loadPixel(const float* p)
+        {
+            vfloat4 out;
+            out.load(p);
+            return out;
+        }
+
+        // Convert a pixel from normalized floating point and store it.
+        void storePixel(uint8_t* p, const vfloat4& value)
+        {
+            const vfloat4 v = OIIO::simd::clamp(value, vfloat4::Zero(), vfloat4::One());
+            vint4(v * 255.F + 0.5F).store(p);
+        }
+
+        void storePixel(uint16_t* p, const vfloat4& value)
+        {
+            const vfloat4 v = OIIO::simd::clamp(value, vfloat4::Zero(), vfloat4::One());
+            vint4(v * 65535.F + 0.5F).store(p);
+        }
+
+        void storePixel(half* p, const vfloat4& value)
+        {
+            value.store(p);
+        }
+
+        void storePixel(float* p, const vfloat4& value)
+        {
+            value.store(p);
+        }
+
+        template<typename FG, typename BG>
+        void compOverPixels(
+            OIIO::ImageBuf& bg,
+            const OIIO::ImageBuf& fg,
+            bool premult,
+            const OIIO::ROI& roi)
+        {
+            OIIO::ImageBufAlgo::parallel_image(
+                roi,
+                [&bg, &fg, premult](OIIO::ROI roi)
+                {
+                    const vfloat4 one = vfloat4::One();
+                    for (int z = roi.zbegin; z < roi.zend; ++z)
+                    {
+                        for (int y = roi.ybegin; y < roi.yend; ++y)
+                        {
+                            const FG* fgP = static_cast<const FG*>(fg.pixeladdr(roi.xbegin, y, z));
+                            BG* bgP = static_cast<BG*>(bg.pixeladdr(roi.xbegin, y, z));
+                            for (int x = roi.xbegin; x < roi.xend; ++x, fgP += 4, bgP += 4)
+                            {
+                                vfloat4 v = loadPixel(fgP);
+                                const float a = std::min(std::max(v[3], 0.F), 1.F);
+                                if (premult)
+                                {
+                                    if (a <= 0.F)
+                                    {
+                                        continue;
+                                    }
+                                    v *= vfloat4(a, a, a, 1.F);
+                                }
+                                if (a < 1.F)
+                                {
+                                    v += loadPixel(bgP) * (one - vfloat4(a));
+                                }
+                                storePixel(bgP, v);
+                            }
+                        }
+                    }
+                });
+        }
+
+        template<typename FG, typename DST>
+        void compOverColorPixels(
+            OIIO::ImageBuf& dst,
+            const OIIO::ImageBuf& fg,
+            const vfloat4& color,
+            bool premult,
+            const OIIO::ROI& roi)
+        {
+            OIIO::ImageBufAlgo::parallel_image(
+                roi,
+                [&dst, &fg, &color, premult](OIIO::ROI roi)
+                {
+                    const vfloat4 one = vfloat4::One();
+                    for (int z = roi.zbegin; z < roi.zend; ++z)
+                    {
+                        for (int y = roi.ybegin; y < roi.yend; ++y)
+                        {
+                            const FG* fgP = static_cast<const FG*>(fg.pixeladdr(roi.xbegin, y, z));
+                            DST* dstP = static_cast<DST*>(dst.pixeladdr(roi.xbegin, y, z));
+                            for (int x = roi.xbegin; x < roi.xend; ++x, fgP += 4, dstP += 4)
+                            {
+                                vfloat4 v = loadPixel(fgP);
+                                const float a = std::min(std::max(v[3], 0.F), 1.F);
+                                if (premult)
+                                {
+                                    v *= vfloat4(a, a, a, 1.F);
+                                }
+                                v += color * (one - vfloat4(a));
+                                storePixel(dstP, v);
+                            }
+                        }
+                    }
+                });
+        }
+
+        template<typename FG>
+        bool compOverColorDST(
+            OIIO::ImageBuf& dst,
+            const OIIO::ImageBuf& fg,
+            const vfloat4& color,
+            bool premult,
+            const OIIO::ROI& roi)
+        {
+            bool out = true;
+            switch (dst.spec().format.basetype)
+            {
+            case OIIO::TypeDesc::UINT8: compOverColorPixels<FG, uint8_t>(dst, fg, color, premult, roi); break;
+            case OIIO::TypeDesc::UINT16: compOverColorPixels<FG, uint16_t>(dst, fg, color, premult, roi); break;
+            case OIIO::TypeDesc::HALF: compOverColorPixels<FG, half>(dst, fg, color, premult, roi); break;
+            case OIIO::TypeDesc::FLOAT: compOverColorPixels<FG, float>(dst, fg, color, premult, roi); break;
+            default: out = false; break;
+            }
+            return out;
+        }
+
+        template<typename FG>
+        bool compOverBG(
+            OIIO::ImageBuf& bg,
+            const OIIO::ImageBuf& fg,
+            bool premult,
+            const OIIO::ROI& roi)
+        {
+            bool out = true;
+            switch (bg.spec().format.basetype)
+            {
+            case OIIO::TypeDesc::UINT8: compOverPixels<FG, uint8_t>(bg, fg, premult, roi); break;
+            case OIIO::TypeDesc::UINT16: compOverPixels<FG, uint16_t>(bg, fg, premult, roi); break;
+            case OIIO::TypeDesc::HALF: compOverPixels<FG, half>(bg, fg, premult, roi); break;
+            case OIIO::TypeDesc::FLOAT: compOverPixels<FG, float>(bg, fg, premult, roi); break;
+            default: out = false; break;
+            }
+            return out;
+        }
+
+        bool isCompOverSupported(const OIIO::ImageBuf& buf)
+        {
+            const auto& spec = buf.spec();
+            const auto basetype = spec.format.basetype;
+            return
+                !buf.deep() &&
+                buf.localpixels() &&
+                4 == spec.nchannels &&
+                3 == spec.alpha_channel &&
+                (OIIO::TypeDesc::UINT8 == basetype ||
+                    OIIO::TypeDesc::UINT16 == basetype ||
+                    OIIO::TypeDesc::HALF == basetype ||
+                    OIIO::TypeDesc::FLOAT == basetype) &&
+                buf.pixel_stride() == static_cast<OIIO::stride_t>(spec.pixel_bytes());
+        }
+    }
+
     CompNode::CompNode(const std::vector<std::shared_ptr<IImageNode> >& inputs) :
         IImageNode("Comp", inputs)
     {}
@@ -26,60 +222,501 @@ namespace toucan
         _resize = resize;
     }
 
-    OIIO::ImageBuf CompNode::exec()
+    std::size_t CompNode::getHash() const
     {
-        OIIO::ImageBuf buf;
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, _premult);
+        hashCombine(out, _resize);
+        if (!_isInputNeeded(1) && _isBackgroundConstant())
+        {
+            // The color of a constant background is used even though the
+            // background is not executed.
+            hashCombine(out, _inputs[1]->getHash());
+        }
+        else if (!_isInputNeeded(1) && _inputs.size() > 1 && _inputs[1])
+        {
+            // The result is resized to a hidden background, so its region
+            // of definition is used even though it is not executed.
+            const OIIO::ROI bgROD = _inputs[1]->getRegionOfDefinition();
+            hashCombine(out, bgROD.xbegin);
+            hashCombine(out, bgROD.xend);
+            hashCombine(out, bgROD.ybegin);
+            hashCombine(out, bgROD.yend);
+        }
+        return out;
+    }
+
+    OIIO::ROI CompNode::getRegionOfDefinition() const
+    {
+        OIIO::ROI out;
+        if (_inputs.size() > 1 && _inputs[1])
+        {
+            out = _inputs[1]->getRegionOfDefinition();
+        }
+        else if (1 == _inputs.size() && _inputs[0])
+        {
+            out = _inputs[0]->getRegionOfDefinition();
+        }
+        return out;
+    }
+
+    bool CompNode::isOpaque() const
+    {
+        bool out = false;
         if (_inputs.size() > 1 && _inputs[0] && _inputs[1])
         {
-            auto fgBuf = _inputs[0]->exec();
-            buf = _inputs[1]->exec();
-            const auto fgSpec = fgBuf.spec();
-            if (_premult &&
-                fgSpec.width > 0 &&
-                fgSpec.height > 0)
-            {
-                fgBuf = OIIO::ImageBufAlgo::premult(fgBuf);
-            }
-            const auto& bgSpec = buf.spec();
-            if (fgSpec.width > 0 && fgSpec.height > 0 &&
-                bgSpec.width > 0 && bgSpec.height > 0 &&
-                (fgSpec.width != bgSpec.width || fgSpec.height != bgSpec.height))
-            {
-                IMATH_NAMESPACE::Box2i fit = toucan::fit(
-                    IMATH_NAMESPACE::V2i(bgSpec.width, bgSpec.height),
-                    IMATH_NAMESPACE::V2i(fgSpec.width, fgSpec.height));
-                const auto resizedBuf = OIIO::ImageBufAlgo::resize(
-                    fgBuf,
-                    "",
-                    0.0,
-                    OIIO::ROI(0, fit.max.x - fit.min.x + 1, 0, fit.max.y - fit.min.y + 1));
-                fgBuf = OIIO::ImageBuf(OIIO::ImageSpec(
-                    bgSpec.width,
-                    bgSpec.height,
-                    bgSpec.nchannels,
-                    bgSpec.format));
-                OIIO::ImageBufAlgo::paste(
-                    fgBuf,
-                    fit.min.x,
-                    fit.min.y,
-                    0,
-                    0,
-                    resizedBuf);
-            }
-            if (fgSpec.width > 0 &&
-                fgSpec.height > 0)
-            {
-                buf = OIIO::ImageBufAlgo::over(fgBuf, buf);
+            out = _inputs[1]->isOpaque() || _isBackgroundHidden();
+        }
+        else if (1 == _inputs.size() && _inputs[0])
+        {
+            out = _inputs[0]->isOpaque();
+        }
+        return out;
+    }
+
+    OIIO::TypeDesc CompNode::getFormat() const
+    {
+        OIIO::TypeDesc out = IImageNode::getFormat();
+        if (_inputs.size() > 1 && _inputs[0] && _inputs[1])
+        {
+            const OIIO::TypeDesc fg = _inputs[0]->getFormat();
+            const OIIO::TypeDesc bg = _inputs[1]->getFormat();
+            if (!_isInputNeeded(0))
+            {
+                out = bg;
+            }
+            else if (_isBackgroundHidden() || OIIO::TypeDesc::UNKNOWN == bg)
+            {
+                out = fg;
+            }
+            else if (OIIO::TypeDesc::UNKNOWN == fg)
+            {
+                out = bg;
+            }
+            else
+            {
+                out = OIIO::TypeDesc::basetype_merge(fg, bg);
+            }
+        }
+        return out;
+    }
+
+    OIIO::ImageBuf CompNode::_exec()
+    {
+        OIIO::ImageBuf buf;
+        if (_inputs.size() > 1 && _inputs[0] && _inputs[1] && !_isInputNeeded(0))
+        {
+            // The foreground is transparent, so the result is the
+            // background.
+            buf = _execInput(1);
+        }
+        else if (_inputs.size() > 1 && _inputs[0] && _inputs[1] && _isBackgroundHidden())
+        {
+            // The background is hidden by the foreground, so the result
+            // is the foreground resized to the background.
+            buf = _execInput(0);
+            const OIIO::ROI bgROD = _inputs[1]->getRegionOfDefinition();
+            const auto spec = buf.spec();
+            if (spec.width != bgROD.width() || spec.height != bgROD.height())
+            {
+                OIIO::ImageBuf resizedBuf = _allocateImage(
+                    OIIO::ImageSpec(
+                        bgROD.width(),
+                        bgROD.height(),
+                        spec.nchannels,
+                        spec.format),
+                    OIIO::InitializePixels::No);
+                OIIO::ImageBufAlgo::resize(resizedBuf, buf);
+                buf = std::move(resizedBuf);
+            }
+            if (3 == spec.nchannels && spec.alpha_channel < 0)
+            {
+                const int channelOrder[] = { 0, 1, 2, -1 };
+                const float channelValues[] = { 0, 0, 0, 1.0 };
+                const std::string channelNames[] = { "", "", "", "A" };
+                OIIO::ImageBuf rgba = _allocateImage(
+                    OIIO::ImageSpec(bgROD.width(), bgROD.height(), 4, spec.format),
+                    OIIO::InitializePixels::No);
+                OIIO::ImageBufAlgo::channels(rgba, buf, 4, channelOrder, channelValues, channelNames);
+                buf = std::move(rgba);
+            }
+        }
+        else if (_inputs.size() > 1 && _inputs[0] && _inputs[1])
+        {
+            auto fgBuf = _execInput(0);
+            const auto constant = dynamic_cast<const ConstantNode*>(_inputs[1].get());
+            if (!constant || !_compOverConstant(fgBuf, *constant, buf))
+            {
+                if (constant)
+                {
+                    // Fill in the constant background.
+                    const IMATH_NAMESPACE::V2i& size = constant->getSize();
+                    const IMATH_NAMESPACE::V4f& color = constant->getColor();
+                    buf = _allocateImage(
+                        OIIO::ImageSpec(size.x, size.y, 4),
+                        OIIO::InitializePixels::No);
+                    const float values[] = { color.x, color.y, color.z, color.w };
+                    OIIO::ImageBufAlgo::fill(buf, values);
+                }
+                else
+                {
+                    buf = _execInput(1);
+                }
+                const auto fgSpec = fgBuf.spec();
+                const auto bgSpec = buf.spec();
+                const bool resize =
+                    fgSpec.width > 0 && fgSpec.height > 0 &&
+                    bgSpec.width > 0 && bgSpec.height > 0 &&
+                    (fgSpec.width != bgSpec.width || fgSpec.height != bgSpec.height);
+
+                // The foreground is pre-multiplied before it is resized, so
+                // that the filter is applied to the pre-multiplied colors.
+                // Otherwise it is pre-multiplied while compositing.
+                if (_premult && resize)
+                {
+                    const OIIO::ROI fgROI = _getInputROI(0, _roi);
+                    if (fgROI.defined())
+                    {
+                        OIIO::ImageBufAlgo::premult(
+                            fgBuf,
+                            fgBuf,
+                            OIIO::roi_intersection(fgROI, fgBuf.roi()));
+                    }
+                    else
+                    {
+                        OIIO::ImageBufAlgo::premult(fgBuf, fgBuf);
+                    }
+                }
+                if (resize)
+                {
+                    IMATH_NAMESPACE::Box2i fit = toucan::fit(
+                        IMATH_NAMESPACE::V2i(bgSpec.width, bgSpec.height),
+                        IMATH_NAMESPACE::V2i(fgSpec.width, fgSpec.height));
+                    OIIO::ImageBuf resizedBuf = _allocateImage(
+                        OIIO::ImageSpec(
+                            fit.max.x - fit.min.x + 1,
+                            fit.max.y - fit.min.y + 1,
+                            fgSpec.nchannels,
+                            fgSpec.format),
+                        OIIO::InitializePixels::No);
+                    OIIO::ImageBufAlgo::resize(resizedBuf, fgBuf);
+                    fgBuf = _allocateImage(OIIO::ImageSpec(
+                        bgSpec.width,
+                        bgSpec.height,
+                        bgSpec.nchannels,
+                        bgSpec.format));
+                    OIIO::ImageBufAlgo::paste(
+                        fgBuf,
+                        fit.min.x,
+                        fit.min.y,
+                        0,
+                        0,
+                        resizedBuf);
+                }
+                if (fgSpec.width > 0 &&
+                    fgSpec.height > 0)
+                {
+                    // Convert the background if the foreground has more
+                    // precision.
+                    const OIIO::TypeDesc format = OIIO::TypeDesc::basetype_merge(
+                        fgBuf.spec().format,
+                        buf.spec().format);
+                    if (format != buf.spec().format)
+                    {
+                        OIIO::ImageSpec spec = buf.spec();
+                        spec.set_format(format);
+                        OIIO::ImageBuf tmp = _allocateImage(spec, OIIO::InitializePixels::No);
+                        tmp.copy_pixels(buf);
+                        buf = std::move(tmp);
+                    }
+
+                    const bool premult = _premult && !resize;
+                    const OIIO::ROI roi = _roi.defined() ?
+                        OIIO::roi_intersection(_roi, buf.roi()) :
+                        OIIO::ROI::All();
+                    if (!compOver(buf, fgBuf, premult, roi))
+                    {
+                        if (premult)
+                        {
+                            OIIO::ImageBufAlgo::premult(
+                                fgBuf,
+                                fgBuf,
+                                roi.defined() ?
+                                    OIIO::roi_intersection(roi, fgBuf.roi()) :
+                                    fgBuf.roi());
+                        }
+                        OIIO::ImageBuf overBuf = _allocateImage(
+                            buf.spec(),
+                            roi.defined() ?
+                                OIIO::InitializePixels::Yes :
+                                OIIO::InitializePixels::No);
+                        OIIO::ImageBufAlgo::over(overBuf, fgBuf, buf, roi);
+                        buf = std::move(overBuf);
+                    }
+                }
             }
         }
         else if (1 == _inputs.size() && _inputs[0])
         {
-            buf = _inputs[0]->exec();
+            buf = _execInput(0);
             if (_premult)
             {
-                buf = OIIO::ImageBufAlgo::premult(buf);
+                if (_roi.defined())
+                {
+                    OIIO::ImageBufAlgo::premult(
+                        buf,
+                        buf,
+                        OIIO::roi_intersection(_roi, buf.roi()));
+                }
+                else
+                {
+                    OIIO::ImageBufAlgo::premult(buf, buf);
+                }
             }
         }
         return buf;
     }
+
+    OIIO::ROI CompNode::_getInputROI(size_t index, const OIIO::ROI& roi) const
+    {
+        OIIO::ROI out = roi;
+        if (roi.defined() &&
+            0 == index &&
+            _inputs.size() > 1 &&
+            _inputs[0] &&
+            _inputs[1])
+        {
+            // The foreground is resized to fit the background if the sizes
+            // are different, so map the region into the foreground.
+            const OIIO::ROI fgROD = _inputs[0]->getRegionOfDefinition();
+            const OIIO::ROI bgROD = _inputs[1]->getRegionOfDefinition();
+            if (!fgROD.defined() || !bgROD.defined())
+            {
+                out = OIIO::ROI::All();
+            }
+            else if (fgROD.width() != bgROD.width() || fgROD.height() != bgROD.height())
+            {
+                const IMATH_NAMESPACE::Box2i fit = toucan::fit(
+                    IMATH_NAMESPACE::V2i(bgROD.width(), bgROD.height()),
+                    IMATH_NAMESPACE::V2i(fgROD.width(), fgROD.height()));
+                const double sx = fgROD.width() / static_cast<double>(fit.max.x - fit.min.x + 1);
+                const double sy = fgROD.height() / static_cast<double>(fit.max.y - fit.min.y + 1);
+
+                // Add a margin for the resize filter.
+                const int margin = static_cast<int>(std::ceil(std::max(sx, sy))) * 3 + 1;
+                out = OIIO::roi_intersection(
+                    OIIO::ROI(
+                        static_cast<int>(std::floor((roi.xbegin - fit.min.x) * sx)) - margin,
+                        static_cast<int>(std::ceil((roi.xend - fit.min.x) * sx)) + margin,
+                        static_cast<int>(std::floor((roi.ybegin - fit.min.y) * sy)) - margin,
+                        static_cast<int>(std::ceil((roi.yend - fit.min.y) * sy)) + margin),
+                    fgROD);
+            }
+        }
+        return out;
+    }
+
+    bool CompNode::_isInputNeeded(size_t index) const
+    {
+        bool out = true;
+        if (0 == index)
+        {
+            out = !_isForegroundTransparent();
+        }
+        else if (1 == index)
+        {
+            out =
+                _isForegroundTransparent() ||
+                !(_isBackgroundHidden() || _isBackgroundConstant());
+        }
+        return out;
+    }
+
+    bool CompNode::_compOverConstant(
+        OIIO::ImageBuf& fgBuf,
+        const ConstantNode& constant,
+        OIIO::ImageBuf& out)
+    {
+        // Composite over the color of the constant background, without
+        // allocating the background. This is only done if the foreground
+        // does not need to be resized.
+        bool ok = false;
+        const IMATH_NAMESPACE::V2i& size = constant.getSize();
+        const OIIO::ROI fgROI = fgBuf.roi();
+        if (0 == fgROI.xbegin && size.x == fgROI.xend &&
+            0 == fgROI.ybegin && size.y == fgROI.yend)
+        {
+            const OIIO::ROI roi = _roi.defined() ?
+                OIIO::roi_intersection(_roi, fgROI) :
+                OIIO::ROI::All();
+            OIIO::ImageSpec spec = fgBuf.spec();
+            spec.set_format(OIIO::TypeDesc::basetype_merge(
+                spec.format,
+                OIIO::TypeDesc::FLOAT));
+            if (spec.format == fgBuf.spec().format)
+            {
+                ok = compOverColor(fgBuf, fgBuf, constant.getColor(), _premult, roi);
+                if (ok)
+                {
+                    out = std::move(fgBuf);
+                }
+            }
+            else
+            {
+                OIIO::ImageBuf dst = _allocateImage(spec, OIIO::InitializePixels::No);
+                ok = compOverColor(dst, fgBuf, constant.getColor(), _premult, roi);
+                if (ok)
+                {
+                    out = std::move(dst);
+                }
+            }
+        }
+        return ok;
+    }
+
+    bool CompNode::_isForegroundTransparent() const
+    {
+        bool out = false;
+        if (_inputs.size() > 1 && _inputs[0] && _inputs[1])
+        {
+            if (auto constant = dynamic_cast<const ConstantNode*>(_inputs[0].get()))
+            {
+                out = constant->isTransparent();
+            }
+        }
+        return out;
+    }
+
+    bool CompNode::_isBackgroundConstant() const
+    {
+        return
+            _inputs.size() > 1 &&
+            _inputs[0] &&
+            dynamic_cast<const ConstantNode*>(_inputs[1].get());
+    }
+
+    bool CompNode::_isBackgroundHidden() const
+    {
+        bool out = false;
+        if (_inputs.size() > 1 &&
+            _inputs[0] &&
+            _inputs[1] &&
+            _inputs[0]->isOpaque())
+        {
+            // The foreground is resized to fit the background, so it
+            // covers the background if the aspect ratios are the same.
+            const OIIO::ROI fgROD = _inputs[0]->getRegionOfDefinition();
+            const OIIO::ROI bgROD = _inputs[1]->getRegionOfDefinition();
+            if (fgROD.defined() && bgROD.defined() &&
+                fgROD.width() > 0 && fgROD.height() > 0 &&
+                bgROD.width() > 0 && bgROD.height() > 0)
+            {
+                if (fgROD.width() == bgROD.width() && fgROD.height() == bgROD.height())
+                {
+                    out = fgROD.xbegin == bgROD.xbegin && fgROD.ybegin == bgROD.ybegin;
+                }
+                else
+                {
+                    const IMATH_NAMESPACE::Box2i fit = toucan::fit(
+                        IMATH_NAMESPACE::V2i(bgROD.width(), bgROD.height()),
+                        IMATH_NAMESPACE::V2i(fgROD.width(), fgROD.height()));
+                    out =
+                        0 == fit.min.x &&
+                        0 == fit.min.y &&
+                        bgROD.width() - 1 == fit.max.x &&
+                        bgROD.height() - 1 == fit.max.y;
+                }
+            }
+        }
+        return out;
+    }
+
+    bool compOver(
+        OIIO::ImageBuf& bg,
+        const OIIO::ImageBuf& fg,
+        bool premult,
+        const OIIO::ROI& roi)
+    {
+        if (!isCompOverSupported(bg) || !isCompOverSupported(fg))
+        {
+            return false;
+        }
+        const OIIO::ROI fgROI = fg.roi();
+        const OIIO::ROI bgROI = bg.roi();
+        if (fgROI.xbegin < bgROI.xbegin || fgROI.xend > bgROI.xend ||
+            fgROI.ybegin < bgROI.ybegin || fgROI.yend > bgROI.yend ||
+            fgROI.zbegin < bgROI.zbegin || fgROI.zend > bgROI.zend)
+        {
+            return false;
+        }
+
+        // Pixels outside of the foreground are not changed.
+        OIIO::ROI compROI = roi.defined() ?
+            OIIO::roi_intersection(roi, fgROI) :
+            fgROI;
+        compROI.chbegin = 0;
+        compROI.chend = 4;
+        if (compROI.xbegin >= compROI.xend ||
+            compROI.ybegin >= compROI.yend ||
+            compROI.zbegin >= compROI.zend)
+        {
+            return true;
+        }
+
+        bool out = true;
+        switch (fg.spec().format.basetype)
+        {
+        case OIIO::TypeDesc::UINT8: out = compOverBG<uint8_t>(bg, fg, premult, compROI); break;
+        case OIIO::TypeDesc::UINT16: out = compOverBG<uint16_t>(bg, fg, premult, compROI); break;
+        case OIIO::TypeDesc::HALF: out = compOverBG<half>(bg, fg, premult, compROI); break;
+        case OIIO::TypeDesc::FLOAT: out = compOverBG<float>(bg, fg, premult, compROI); break;
+        default: out = false; break;
+        }
+        return out;
+    }
+
+    bool compOverColor(
+        OIIO::ImageBuf& dst,
+        const OIIO::ImageBuf& fg,
+        const IMATH_NAMESPACE::V4f& color,
+        bool premult,
+        const OIIO::ROI& roi)
+    {
+        if (!isCompOverSupported(dst) || !isCompOverSupported(fg))
+        {
+            return false;
+        }
+        const OIIO::ROI fgROI = fg.roi();
+        const OIIO::ROI dstROI = dst.roi();
+        if (fgROI.xbegin != dstROI.xbegin || fgROI.xend != dstROI.xend ||
+            fgROI.ybegin != dstROI.ybegin || fgROI.yend != dstROI.yend ||
+            fgROI.zbegin != dstROI.zbegin || fgROI.zend != dstROI.zend)
+        {
+            return false;
+        }
+
+        OIIO::ROI compROI = roi.defined() ?
+            OIIO::roi_intersection(roi, fgROI) :
+            fgROI;
+        compROI.chbegin = 0;
+        compROI.chend = 4;
+        if (compROI.xbegin >= compROI.xend ||
+            compROI.ybegin >= compROI.yend ||
+            compROI.zbegin >= compROI.zend)
+        {
+            return true;
+        }
+
+        const vfloat4 c(color.x, color.y, color.z, color.w);
+        bool out = true;
+        switch (fg.spec().format.basetype)
+        {
+        case OIIO::TypeDesc::UINT8: out = compOverColorDST<uint8_t>(dst, fg, c, premult, compROI); break;
+        case OIIO::TypeDesc::UINT16: out = compOverColorDST<uint16_t>(dst, fg, c, premult, compROI); break;
+        case OIIO::TypeDesc::HALF: out = compOverColorDST<half>(dst, fg, c, premult, compROI); break;
+        case OIIO::TypeDesc::FLOAT: out = compOverColorDST<float>(dst, fg, c, premult, compROI); break;
+        default: out = false; break;
+        }
+        return out;
+    }
 }
@@ -5,8 +5,12 @@
 
 #include <toucanRender/ImageNode.h>
 
+#include <Imath/ImathVec.h>
+
 namespace toucan
 {
+    class ConstantNode;
+
     //! Compositing node.
     class CompNode : public IImageNode
     {
@@ -21,10 +25,58 @@ namespace toucan
         //! Set whether images are resized before compositing.
         void setResize(bool);
 
-        OIIO::ImageBuf exec() override;
+        std::size_t getHash() const override;
+        OIIO::ROI getRegionOfDefinition() const override;
+        bool isOpaque() const override;
+
+        //! The background is converted to the format of the foreground if
+        //! it has more precision.
+        OIIO::TypeDesc getFormat() const override;
+
+    protected:
+        OIIO::ImageBuf _exec() override;
+        OIIO::ROI _getInputROI(size_t, const OIIO::ROI&) const override;
+        bool _isInputNeeded(size_t) const override;
 
     private:
+        bool _compOverConstant(
+            OIIO::ImageBuf&,
+            const ConstantNode&,
+            OIIO::ImageBuf&);
+        bool _isForegroundTransparent() const;
+        bool _isBackgroundHidden() const;
+        bool _isBackgroundConstant() const;
+
         bool _premult = false;
         bool _resize = true;
     };
+
+    //! Composite a foreground image over a background image, in place. If
+    //! premult is true the foreground is pre-multiplied by its alpha in the
+    //! same pass.
+    //!
+    //! The images must be RGBA with u8, u16, half, or float pixels in
+    //! memory, and the foreground must be within the background. Returns
+    //! false without changing the background if the images are not
+    //! supported.
+    bool compOver(
+        OIIO::ImageBuf& bg,
+        const OIIO::ImageBuf& fg,
+        bool premult,
+        const OIIO::ROI& = OIIO::ROI::All());
+
+    //! Composite a foreground image over a constant color. The result is
+    //! written to the destination image, which can be the foreground
+    //! image. If premult is true the foreground is pre-multiplied by its
+    //! alpha in the same pass.
+    //!
+    //! The images must be RGBA with u8, u16, half, or float pixels in
+    //! memory, and have the same data window. Returns false without
+    //! changing the destination if the images are not supported.
+    bool compOverColor(
+        OIIO::ImageBuf& dst,
+        const OIIO::ImageBuf& fg,
+        const IMATH_NAMESPACE::V4f& color,
+        bool premult,
+        const OIIO::ROI& = OIIO::ROI::All());
 }
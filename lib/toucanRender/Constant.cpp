@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "Constant.h"
+
+#include "Util.h"
+
+#include <OpenImageIO/imagebufalgo.h>
+
+#include <sstream>
+
+namespace toucan
+{
+    ConstantNode::ConstantNode(
+        const IMATH_NAMESPACE::V2i& size,
+        const IMATH_NAMESPACE::V4f& color) :
+        IImageNode("Constant"),
+        _size(size),
+        _color(color)
+    {}
+
+    ConstantNode::~ConstantNode()
+    {}
+
+    const IMATH_NAMESPACE::V2i& ConstantNode::getSize() const
+    {
+        return _size;
+    }
+
+    void ConstantNode::setSize(const IMATH_NAMESPACE::V2i& value)
+    {
+        _size = value;
+    }
+
+    const IMATH_NAMESPACE::V4f& ConstantNode::getColor() const
+    {
+        return _color;
+    }
+
+    void ConstantNode::setColor(const IMATH_NAMESPACE::V4f& value)
+    {
+        _color = value;
+    }
+
+    bool ConstantNode::isTransparent() const
+    {
+        return
+            _color.x == 0.F &&
+            _color.y == 0.F &&
+            _color.z == 0.F &&
+            _color.w <= 0.F;
+    }
+
+    std::string ConstantNode::getLabel() const
+    {
+        std::stringstream ss;
+        ss << _name << " " << _color.x << " " << _color.y << " " << _color.z << " " << _color.w;
+        return ss.str();
+    }
+
+    std::size_t ConstantNode::getHash() const
+    {
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, _size.x);
+        hashCombine(out, _size.y);
+        hashCombine(out, std::hash<float>()(_color.x));
+        hashCombine(out, std::hash<float>()(_color.y));
+        hashCombine(out, std::hash<float>()(_color.z));
+        hashCombine(out, std::hash<float>()(_color.w));
+        return out;
+    }
+
+    OIIO::ROI ConstantNode::getRegionOfDefinition() const
+    {
+        OIIO::ROI out;
+        if (_size.x > 0 && _size.y > 0)
+        {
+            out = OIIO::ROI(0, _size.x, 0, _size.y);
+        }
+        return out;
+    }
+
+    bool ConstantNode::isOpaque() const
+    {
+        return _color.w >= 1.F;
+    }
+
+    OIIO::TypeDesc ConstantNode::getFormat() const
+    {
+        return OIIO::TypeDesc::FLOAT;
+    }
+
+    OIIO::ImageBuf ConstantNode::_exec()
+    {
+        OIIO::ImageBuf out;
+        if (_size.x > 0 && _size.y > 0)
+        {
+            out = _allocateImage(
+                OIIO::ImageSpec(_size.x, _size.y, 4),
+                OIIO::InitializePixels::No);
+            const float color[] = { _color.x, _color.y, _color.z, _color.w };
+            OIIO::ImageBufAlgo::fill(
+                out,
+                color,
+                _roi.defined() ? OIIO::roi_intersection(_roi, out.roi()) : out.roi());
+        }
+        return out;
+    }
+}
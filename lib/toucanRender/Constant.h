@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <toucanRender/ImageNode.h>
+
+#include <Imath/ImathVec.h>
+
+namespace toucan
+{
+    //! Constant color node.
+    //!
+    //! The node carries its size and color without pixels, so that the
+    //! compositor can use the color directly. The pixels are only filled
+    //! in when a consumer needs them, for example an image effect.
+    class ConstantNode : public IImageNode
+    {
+    public:
+        ConstantNode(
+            const IMATH_NAMESPACE::V2i& size = IMATH_NAMESPACE::V2i(0, 0),
+            const IMATH_NAMESPACE::V4f& color = IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 0.F));
+
+        virtual ~ConstantNode();
+
+        //! Get the size.
+        const IMATH_NAMESPACE::V2i& getSize() const;
+
+        //! Set the size.
+        void setSize(const IMATH_NAMESPACE::V2i&);
+
+        //! Get the color.
+        const IMATH_NAMESPACE::V4f& getColor() const;
+
+        //! Set the color.
+        void setColor(const IMATH_NAMESPACE::V4f&);
+
+        //! Get whether the image is fully transparent. Compositing a
+        //! transparent image over another image does not change it.
+        bool isTransparent() const;
+
+        std::string getLabel() const override;
+        std::size_t getHash() const override;
+        OIIO::ROI getRegionOfDefinition() const override;
+        bool isOpaque() const override;
+        OIIO::TypeDesc getFormat() const override;
+
+    protected:
+        OIIO::ImageBuf _exec() override;
+
+    private:
+        IMATH_NAMESPACE::V2i _size = IMATH_NAMESPACE::V2i(0, 0);
+        IMATH_NAMESPACE::V4f _color = IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 0.F);
+    };
+}
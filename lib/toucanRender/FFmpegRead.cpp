@@ -5,6 +5,7 @@
 
 #include <ftk/Core/String.h>
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -12,6 +13,7 @@ extern "C"
 {
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 }
 
 namespace toucan
@@ -43,7 +45,8 @@ namespace toucan
             const std::filesystem::path& path,
             const MemoryReference& memoryReference) :
             _path(path),
-            _memoryReference(memoryReference)
+            _memoryReference(memoryReference),
+            _memoryPool(ImageMemoryPool::get())
         {
             av_log_set_level(AV_LOG_QUIET);
             //av_log_set_level(AV_LOG_VERBOSE);
@@ -200,8 +203,8 @@ namespace toucan
                 switch (_avInputPixelFormat)
                 {
                 case AV_PIX_FMT_RGB24:
-                    _avOutputPixelFormat = _avInputPixelFormat;
-                    nchannels = 3;
+                    _avOutputPixelFormat = AV_PIX_FMT_RGBA;
+                    nchannels = 4;
                     format = OIIO::TypeUInt8;
                     break;
                 case AV_PIX_FMT_GRAY8:
@@ -217,8 +220,8 @@ namespace toucan
                 case AV_PIX_FMT_YUV420P:
                 case AV_PIX_FMT_YUV422P:
                 case AV_PIX_FMT_YUV444P:
-                    _avOutputPixelFormat = AV_PIX_FMT_RGB24;
-                    nchannels = 3;
+                    _avOutputPixelFormat = AV_PIX_FMT_RGBA;
+                    nchannels = 4;
                     format = OIIO::TypeUInt8;
                     break;
                 case AV_PIX_FMT_YUV420P10BE:
@@ -239,8 +242,8 @@ namespace toucan
                 case AV_PIX_FMT_YUV444P12LE:
                 case AV_PIX_FMT_YUV444P16BE:
                 case AV_PIX_FMT_YUV444P16LE:
-                    _avOutputPixelFormat = AV_PIX_FMT_RGB48;
-                    nchannels = 3;
+                    _avOutputPixelFormat = AV_PIX_FMT_RGBA64;
+                    nchannels = 4;
                     format = OIIO::TypeUInt16;
                     break;
                 case AV_PIX_FMT_YUVA420P:
@@ -261,8 +264,8 @@ namespace toucan
                     format = OIIO::TypeUInt16;
                     break;
                 default:
-                    _avOutputPixelFormat = AV_PIX_FMT_RGB24;
-                    nchannels = 3;
+                    _avOutputPixelFormat = AV_PIX_FMT_RGBA;
+                    nchannels = 4;
                     format = OIIO::TypeUInt8;
                     break;
                 }
@@ -330,8 +333,10 @@ namespace toucan
                 {
                     throw std::runtime_error("Cannot allocate frame");
                 }
-                //! \bug These fields need to be filled out for
-                //! sws_scale_frame()?
+                // The destination frame points at the pixels of the output
+                // image, see _read(). The buffer is only set so that
+                // sws_scale_frame() does not allocate a new one, it is not
+                // written to.
                 _avFrame2->format = _avOutputPixelFormat;
                 _avFrame2->width = width;
                 _avFrame2->height = height;
@@ -396,6 +401,7 @@ namespace toucan
 
         Read::~Read()
         {
+            _readAheadStop();
             if (_swsContext)
             {
                 sws_freeContext(_swsContext);
@@ -441,13 +447,55 @@ namespace toucan
             return _timeRange;
         }
 
-        OIIO::ImageBuf Read::getImage(const OTIO_NS::RationalTime& time)
+        bool Read::isOpaque() const
+        {
+            // Gray images do not have an alpha channel added.
+            const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(_avInputPixelFormat);
+            return
+                4 == _spec.nchannels &&
+                desc &&
+                !(desc->flags & AV_PIX_FMT_FLAG_ALPHA);
+        }
+
+        void Read::setReadAhead(size_t value)
         {
+            if (value == _readAhead)
+            {
+                return;
+            }
+            _readAheadStop();
+            _readAhead = value;
+            if (_readAhead > 0 && _avStream != -1)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_readAheadMutex.mutex);
+                    _readAheadClear();
+                    _readAheadMutex.decodeTime = _currentTime;
+                    _readAheadMutex.seek = false;
+                    _readAheadMutex.eof = false;
+                    _readAheadMutex.running = true;
+                }
+                _readAheadThread = std::thread(
+                    [this]
+                    {
+                        _readAheadRun();
+                    });
+            }
+        }
+
+        OIIO::ImageBuf Read::getImage(
+            const OTIO_NS::RationalTime& time,
+            ImageArena* arena)
+        {
+            if (_readAheadThread.joinable())
+            {
+                return _readAheadImage(time, arena);
+            }
             if (time != _currentTime)
             {
                 _seek(time);
             }
-            return _read();
+            return _read(arena);
         }
 
         void Read::_seek(const OTIO_NS::RationalTime& time)
@@ -471,9 +519,9 @@ namespace toucan
             _eof = false;
         }
 
-        OIIO::ImageBuf Read::_read()
+        bool Read::_decode()
         {
-            OIIO::ImageBuf out;
+            bool out = false;
             if (_avStream != -1)
             {
                 Packet packet;
@@ -528,18 +576,8 @@ namespace toucan
 
                             if (frameTime >= _currentTime)
                             {
-                                out = OIIO::ImageBuf(_spec);
-
-                                av_image_fill_arrays(
-                                    _avFrame2->data,
-                                    _avFrame2->linesize,
-                                    (const uint8_t*)out.localpixels(),
-                                    _avOutputPixelFormat,
-                                    _spec.width,
-                                    _spec.height,
-                                    1);
-                                sws_scale_frame(_swsContext, _avFrame2, _avFrame);
-
+                                // The frame is converted by _convert().
+                                out = true;
                                 _currentTime = frameTime + OTIO_NS::RationalTime(1.0, _timeRange.duration().rate());
 
                                 decoding = 1;
@@ -578,6 +616,202 @@ namespace toucan
             return out;
         }
 
+        void Read::_convert(void* data)
+        {
+            // Convert directly into the output pixels.
+            av_image_fill_arrays(
+                _avFrame2->data,
+                _avFrame2->linesize,
+                (const uint8_t*)data,
+                _avOutputPixelFormat,
+                _spec.width,
+                _spec.height,
+                1);
+            sws_scale_frame(_swsContext, _avFrame2, _avFrame);
+        }
+
+        OIIO::ImageBuf Read::_read(ImageArena* arena)
+        {
+            OIIO::ImageBuf out;
+            if (_decode())
+            {
+                // The pixels are not initialized since they are all
+                // overwritten.
+                out = allocateImage(arena, _spec, OIIO::InitializePixels::No);
+                _convert(out.localpixels());
+            }
+            return out;
+        }
+
+        OIIO::ImageBuf Read::_readAheadImage(
+            const OTIO_NS::RationalTime& time,
+            ImageArena* arena)
+        {
+            ImageMemoryBlock block;
+            std::unique_lock<std::mutex> lock(_readAheadMutex.mutex);
+
+            // Discard frames before the requested time.
+            auto& frames = _readAheadMutex.frames;
+            _readAheadDrop(time);
+
+            // Seek if the requested time is not in the buffer and will not
+            // be decoded next.
+            const OTIO_NS::RationalTime decodeEnd =
+                _readAheadMutex.decodeTime +
+                OTIO_NS::RationalTime(_readAhead, _timeRange.duration().rate());
+            const bool buffered = !frames.empty() && frames.front().time == time;
+            const bool ahead =
+                frames.empty() &&
+                !_readAheadMutex.seek &&
+                !_readAheadMutex.eof &&
+                time >= _readAheadMutex.decodeTime &&
+                time < decodeEnd;
+            if (!buffered && !ahead)
+            {
+                _readAheadClear();
+                _readAheadMutex.seek = true;
+                _readAheadMutex.seekTime = time;
+                _readAheadMutex.decodeTime = time;
+                _readAheadMutex.eof = false;
+            }
+            _readAheadCV.notify_all();
+
+            // Wait for the frame.
+            _readAheadCV.wait(
+                lock,
+                [this, &frames, time]
+                {
+                    _readAheadDrop(time);
+                    return !frames.empty() || _readAheadMutex.eof;
+                });
+            if (!frames.empty())
+            {
+                block = std::move(frames.front().block);
+                frames.pop_front();
+            }
+            lock.unlock();
+            _readAheadCV.notify_all();
+
+            // Hand the block to the arena, or copy it to an image with its
+            // own pixel memory and return it to the pool.
+            OIIO::ImageBuf out;
+            if (block.data)
+            {
+                if (arena)
+                {
+                    out = arena->adopt(std::move(block), _spec);
+                }
+                else
+                {
+                    out = OIIO::ImageBuf(_spec, OIIO::InitializePixels::No);
+                    std::memcpy(out.localpixels(), block.data.get(), _spec.image_bytes());
+                    _memoryPool->release(std::move(block));
+                }
+            }
+            return out;
+        }
+
+        void Read::_readAheadRun()
+        {
+            const OTIO_NS::RationalTime frameDuration(1.0, _timeRange.duration().rate());
+            while (1)
+            {
+                // Wait for a seek request or room in the buffer.
+                bool seek = false;
+                OTIO_NS::RationalTime seekTime;
+                {
+                    std::unique_lock<std::mutex> lock(_readAheadMutex.mutex);
+                    _readAheadCV.wait(
+                        lock,
+                        [this]
+                        {
+                            return
+                                !_readAheadMutex.running ||
+                                _readAheadMutex.seek ||
+                                (!_readAheadMutex.eof && _readAheadMutex.frames.size() < _readAhead);
+                        });
+                    if (!_readAheadMutex.running)
+                    {
+                        break;
+                    }
+                    if (_readAheadMutex.seek)
+                    {
+                        seek = true;
+                        seekTime = _readAheadMutex.seekTime;
+                        _readAheadMutex.seek = false;
+                    }
+                }
+
+                // Decode the next frame.
+                if (seek)
+                {
+                    _seek(seekTime);
+                }
+                ImageMemoryBlock block;
+                if (_decode())
+                {
+                    block = _memoryPool->acquire(_spec.image_bytes());
+                    _convert(block.data.get());
+                }
+                const OTIO_NS::RationalTime frameTime = _currentTime - frameDuration;
+
+                // Add the frame to the buffer, unless a seek was requested
+                // while decoding.
+                {
+                    std::unique_lock<std::mutex> lock(_readAheadMutex.mutex);
+                    if (!_readAheadMutex.seek)
+                    {
+                        if (block.data)
+                        {
+                            _readAheadMutex.frames.push_back({ frameTime, std::move(block) });
+                            _readAheadMutex.decodeTime = _currentTime;
+                        }
+                        else
+                        {
+                            _readAheadMutex.eof = true;
+                        }
+                    }
+                }
+                if (block.data)
+                {
+                    _memoryPool->release(std::move(block));
+                }
+                _readAheadCV.notify_all();
+            }
+        }
+
+        void Read::_readAheadStop()
+        {
+            if (_readAheadThread.joinable())
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_readAheadMutex.mutex);
+                    _readAheadMutex.running = false;
+                }
+                _readAheadCV.notify_all();
+                _readAheadThread.join();
+            }
+        }
+
+        void Read::_readAheadDrop(const OTIO_NS::RationalTime& time)
+        {
+            auto& frames = _readAheadMutex.frames;
+            while (!frames.empty() && frames.front().time < time)
+            {
+                _memoryPool->release(std::move(frames.front().block));
+                frames.pop_front();
+            }
+        }
+
+        void Read::_readAheadClear()
+        {
+            for (auto& frame : _readAheadMutex.frames)
+            {
+                _memoryPool->release(std::move(frame.block));
+            }
+            _readAheadMutex.frames.clear();
+        }
+
         Read::AVIOBufferData::AVIOBufferData()
         {
         }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <toucanRender/FFmpeg.h>
+#include <toucanRender/ImageArena.h>
 #include <toucanRender/MemoryMap.h>
 
 #include <opentimelineio/version.h>
@@ -18,7 +19,12 @@ extern "C"
 
 } // extern "C"
 
+#include <condition_variable>
 #include <filesystem>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace toucan
 {
@@ -36,11 +42,34 @@ namespace toucan
             const OIIO::ImageSpec& getSpec();
             const OTIO_NS::TimeRange& getTimeRange() const;
 
-            OIIO::ImageBuf getImage(const OTIO_NS::RationalTime&);
+            //! Get whether the images are opaque. Images are converted to
+            //! RGBA, so this is found from the pixel format of the video
+            //! stream.
+            bool isOpaque() const;
+
+            //! Set the number of frames to decode ahead of the last
+            //! requested time on a background thread. Zero disables
+            //! reading ahead and frames are decoded on the caller's thread.
+            void setReadAhead(size_t);
+
+            //! Get an image. The image is allocated from the arena if it
+            //! is not null. Frames that are decoded ahead use blocks from
+            //! the image memory pool, which are handed to the arena or
+            //! returned to the pool when the frame is consumed or dropped.
+            OIIO::ImageBuf getImage(
+                const OTIO_NS::RationalTime&,
+                ImageArena* = nullptr);
 
         private:
             void _seek(const OTIO_NS::RationalTime&);
-            OIIO::ImageBuf _read();
+            bool _decode();
+            void _convert(void*);
+            OIIO::ImageBuf _read(ImageArena*);
+            OIIO::ImageBuf _readAheadImage(const OTIO_NS::RationalTime&, ImageArena*);
+            void _readAheadRun();
+            void _readAheadStop();
+            void _readAheadDrop(const OTIO_NS::RationalTime&);
+            void _readAheadClear();
 
             std::filesystem::path _path;
             MemoryReference _memoryReference;
@@ -74,6 +103,27 @@ namespace toucan
             AVPixelFormat _avOutputPixelFormat = AV_PIX_FMT_NONE;
             SwsContext* _swsContext = nullptr;
             bool _eof = false;
+
+            size_t _readAhead = 0;
+            std::shared_ptr<ImageMemoryPool> _memoryPool;
+            struct ReadAheadFrame
+            {
+                OTIO_NS::RationalTime time;
+                ImageMemoryBlock block;
+            };
+            struct ReadAheadMutex
+            {
+                std::list<ReadAheadFrame> frames;
+                OTIO_NS::RationalTime decodeTime;
+                bool seek = false;
+                OTIO_NS::RationalTime seekTime;
+                bool eof = false;
+                bool running = false;
+                std::mutex mutex;
+            };
+            ReadAheadMutex _readAheadMutex;
+            std::condition_variable _readAheadCV;
+            std::thread _readAheadThread;
         };
     }
 }
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImageArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace toucan
+{
+    namespace
+    {
+        // Round a size up to a size class. There are four classes for
+        // each power of two, so at most a quarter of a block is unused.
+        size_t getSizeClass(size_t value)
+        {
+            size_t out = 4096;
+            while (out < value)
+            {
+                out *= 2;
+            }
+            if (out > 4096)
+            {
+                const size_t half = out / 2;
+                const size_t step = half / 4;
+                for (size_t size = half + step; size < out; size += step)
+                {
+                    if (size >= value)
+                    {
+                        out = size;
+                        break;
+                    }
+                }
+            }
+            return out;
+        }
+    }
+
+    ImageMemoryPool::ImageMemoryPool(size_t maxBytes)
+    {
+        _mutex.max = maxBytes;
+    }
+
+    ImageMemoryPool::~ImageMemoryPool()
+    {}
+
+    std::shared_ptr<ImageMemoryPool> ImageMemoryPool::get()
+    {
+        static const auto pool = std::make_shared<ImageMemoryPool>();
+        return pool;
+    }
+
+    size_t ImageMemoryPool::getMax() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.max;
+    }
+
+    void ImageMemoryPool::setMax(size_t value)
+    {
+        std::multimap<size_t, ImageMemoryBlock> freed;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            _mutex.max = value;
+            while (!_mutex.idle.empty() && _mutex.stats.size > _mutex.max)
+            {
+                // Free the largest blocks first.
+                auto i = std::prev(_mutex.idle.end());
+                _mutex.stats.size -= i->second.size;
+                freed.insert(_mutex.idle.extract(i));
+            }
+        }
+    }
+
+    ImageMemoryPoolStats ImageMemoryPool::getStats() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.stats;
+    }
+
+    ImageMemoryBlock ImageMemoryPool::acquire(size_t size)
+    {
+        ImageMemoryBlock out;
+        const size_t sizeClass = getSizeClass(size);
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            const auto i = _mutex.idle.find(sizeClass);
+            if (i != _mutex.idle.end())
+            {
+                out = std::move(i->second);
+                _mutex.idle.erase(i);
+                _mutex.stats.size -= out.size;
+                ++_mutex.stats.hits;
+                return out;
+            }
+            ++_mutex.stats.misses;
+        }
+        out.data.reset(new char[sizeClass]);
+        out.size = sizeClass;
+        return out;
+    }
+
+    void ImageMemoryPool::release(ImageMemoryBlock&& block)
+    {
+        if (!block.data)
+        {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        if (_mutex.stats.size + block.size <= _mutex.max)
+        {
+            _mutex.stats.size += block.size;
+            _mutex.idle.insert({ block.size, std::move(block) });
+        }
+    }
+
+    void ImageMemoryPool::clear()
+    {
+        std::multimap<size_t, ImageMemoryBlock> freed;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            freed = std::move(_mutex.idle);
+            _mutex.idle.clear();
+            _mutex.stats.size = 0;
+        }
+    }
+
+    ImageArena::ImageArena(const std::shared_ptr<ImageMemoryPool>& pool) :
+        _pool(pool)
+    {}
+
+    ImageArena::~ImageArena()
+    {
+        if (_pool)
+        {
+            for (auto& block : _mutex.blocks)
+            {
+                _pool->release(std::move(block));
+            }
+            for (auto& buffer : _mutex.buffers)
+            {
+                _pool->release(std::move(buffer.block));
+            }
+        }
+    }
+
+    OIIO::ImageBuf ImageArena::allocate(
+        const OIIO::ImageSpec& spec,
+        OIIO::InitializePixels initialize)
+    {
+        OIIO::ImageBuf out;
+        const size_t size = spec.image_bytes();
+        if (!_pool || 0 == size)
+        {
+            return OIIO::ImageBuf(spec, initialize);
+        }
+        ImageMemoryBlock block = _pool->acquire(size);
+        if (OIIO::InitializePixels::Yes == initialize)
+        {
+            std::memset(block.data.get(), 0, size);
+        }
+        out = OIIO::ImageBuf(spec, block.data.get());
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        _mutex.data.insert(block.data.get());
+        _mutex.blocks.push_back(std::move(block));
+        return out;
+    }
+
+    size_t ImageArena::addBuffer(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        Buffer buffer;
+        buffer.size = size;
+        _mutex.buffers.push_back(std::move(buffer));
+        return _mutex.buffers.size() - 1;
+    }
+
+    OIIO::ImageBuf ImageArena::allocate(
+        size_t index,
+        const OIIO::ImageSpec& spec,
+        OIIO::InitializePixels initialize)
+    {
+        const size_t size = spec.image_bytes();
+        char* data = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            if (_pool && size > 0 && index < _mutex.buffers.size() && !_mutex.buffers[index].used)
+            {
+                // The buffer is grown if the image is larger than planned.
+                Buffer& buffer = _mutex.buffers[index];
+                if (buffer.block.size < size)
+                {
+                    _pool->release(std::move(buffer.block));
+                    buffer.size = std::max(buffer.size, size);
+                    buffer.block = _pool->acquire(buffer.size);
+                }
+                buffer.used = true;
+                data = buffer.block.data.get();
+                _mutex.data.insert(data);
+            }
+        }
+        if (!data)
+        {
+            return allocate(spec, initialize);
+        }
+        if (OIIO::InitializePixels::Yes == initialize)
+        {
+            std::memset(data, 0, size);
+        }
+        return OIIO::ImageBuf(spec, data);
+    }
+
+    OIIO::ImageBuf ImageArena::adopt(
+        ImageMemoryBlock&& block,
+        const OIIO::ImageSpec& spec)
+    {
+        OIIO::ImageBuf out(spec, block.data.get());
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        _mutex.data.insert(block.data.get());
+        _mutex.blocks.push_back(std::move(block));
+        return out;
+    }
+
+    bool ImageArena::owns(const OIIO::ImageBuf& buf) const
+    {
+        const void* data = buf.localpixels();
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return data && _mutex.data.find(data) != _mutex.data.end();
+    }
+
+    void ImageArena::release(const OIIO::ImageBuf& buf)
+    {
+        const void* data = buf.localpixels();
+        if (!data)
+        {
+            return;
+        }
+        ImageMemoryBlock block;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            const auto i = _mutex.data.find(data);
+            if (i == _mutex.data.end())
+            {
+                return;
+            }
+            _mutex.data.erase(i);
+
+            // The memory of a buffer is kept for the next image.
+            for (auto& buffer : _mutex.buffers)
+            {
+                if (buffer.block.data.get() == data)
+                {
+                    buffer.used = false;
+                    return;
+                }
+            }
+
+            const auto j = std::find_if(
+                _mutex.blocks.begin(),
+                _mutex.blocks.end(),
+                [data](const ImageMemoryBlock& block)
+                {
+                    return block.data.get() == data;
+                });
+            if (j != _mutex.blocks.end())
+            {
+                block = std::move(*j);
+                *j = std::move(_mutex.blocks.back());
+                _mutex.blocks.pop_back();
+            }
+        }
+        if (_pool)
+        {
+            _pool->release(std::move(block));
+        }
+    }
+
+    OIIO::ImageBuf allocateImage(
+        ImageArena* arena,
+        const OIIO::ImageSpec& spec,
+        OIIO::InitializePixels initialize)
+    {
+        return arena ?
+            arena->allocate(spec, initialize) :
+            OIIO::ImageBuf(spec, initialize);
+    }
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <OpenImageIO/imagebuf.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace toucan
+{
+    //! Image memory block.
+    struct ImageMemoryBlock
+    {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    //! Image memory pool statistics.
+    struct ImageMemoryPoolStats
+    {
+        //! Number of blocks that were re-used.
+        size_t hits = 0;
+
+        //! Number of blocks that were allocated.
+        size_t misses = 0;
+
+        //! Size of the idle blocks in bytes.
+        size_t size = 0;
+    };
+
+    //! Image memory pool.
+    //!
+    //! The pool keeps the pixel memory of images that are no longer used,
+    //! so it can be re-used for later frames instead of allocating new
+    //! memory. Blocks are rounded up to size classes, so images of a
+    //! similar size share blocks. The idle blocks are limited by their
+    //! size in bytes.
+    class ImageMemoryPool
+    {
+    public:
+        ImageMemoryPool(size_t maxBytes = 1024 * 1024 * 1024);
+
+        ~ImageMemoryPool();
+
+        //! Get the process-wide image memory pool.
+        static std::shared_ptr<ImageMemoryPool> get();
+
+        //! Get the maximum size of the idle blocks in bytes.
+        size_t getMax() const;
+
+        //! Set the maximum size of the idle blocks in bytes.
+        void setMax(size_t);
+
+        //! Get the statistics.
+        ImageMemoryPoolStats getStats() const;
+
+        //! Acquire a block of at least the given size.
+        ImageMemoryBlock acquire(size_t);
+
+        //! Release a block.
+        void release(ImageMemoryBlock&&);
+
+        //! Free the idle blocks.
+        void clear();
+
+    private:
+        struct Mutex
+        {
+            size_t max = 0;
+            std::multimap<size_t, ImageMemoryBlock> idle;
+            ImageMemoryPoolStats stats;
+            std::mutex mutex;
+        };
+        mutable Mutex _mutex;
+    };
+
+    //! Image arena.
+    //!
+    //! The arena allocates images for the duration of a frame. The pixel
+    //! memory comes from the image memory pool, and is returned to the
+    //! pool when the image is released or the arena is destroyed. Images
+    //! allocated from the arena must not be used after that, copies of
+    //! them share the pixel memory.
+    class ImageArena
+    {
+    public:
+        ImageArena(const std::shared_ptr<ImageMemoryPool>& = ImageMemoryPool::get());
+
+        ~ImageArena();
+
+        ImageArena(const ImageArena&) = delete;
+        ImageArena& operator = (const ImageArena&) = delete;
+
+        //! Allocate an image.
+        OIIO::ImageBuf allocate(
+            const OIIO::ImageSpec&,
+            OIIO::InitializePixels = OIIO::InitializePixels::Yes);
+
+        //! Add a buffer and return its index. A buffer is a block of
+        //! memory that is re-used by images that are not live at the same
+        //! time, like the buffers of an image plan. The memory is acquired
+        //! from the pool when the buffer is first used.
+        size_t addBuffer(size_t size);
+
+        //! Allocate an image from a buffer. The buffer is in use until the
+        //! image is released. If the buffer is already in use the image is
+        //! allocated from the pool instead.
+        OIIO::ImageBuf allocate(
+            size_t buffer,
+            const OIIO::ImageSpec&,
+            OIIO::InitializePixels = OIIO::InitializePixels::Yes);
+
+        //! Take ownership of a block acquired from the pool and return an
+        //! image that uses it for its pixel memory. The block is returned
+        //! to the pool like the blocks of allocated images.
+        OIIO::ImageBuf adopt(ImageMemoryBlock&&, const OIIO::ImageSpec&);
+
+        //! Get whether the pixel memory of an image is owned by the arena.
+        bool owns(const OIIO::ImageBuf&) const;
+
+        //! Return the pixel memory of an image to the pool before the
+        //! arena is destroyed. Images that are not owned by the arena are
+        //! ignored.
+        void release(const OIIO::ImageBuf&);
+
+    private:
+        std::shared_ptr<ImageMemoryPool> _pool;
+
+        struct Buffer
+        {
+            ImageMemoryBlock block;
+            size_t size = 0;
+            bool used = false;
+        };
+
+        struct Mutex
+        {
+            std::vector<ImageMemoryBlock> blocks;
+            std::vector<Buffer> buffers;
+            std::set<const void*> data;
+            std::mutex mutex;
+        };
+        mutable Mutex _mutex;
+    };
+
+    //! Allocate an image from an arena, or with its own pixel memory if
+    //! the arena is null.
+    OIIO::ImageBuf allocateImage(
+        ImageArena*,
+        const OIIO::ImageSpec&,
+        OIIO::InitializePixels = OIIO::InitializePixels::Yes);
+}
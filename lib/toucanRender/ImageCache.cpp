@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImageCache.h"
+
+namespace toucan
+{
+    ImageCache::ImageCache(size_t maxBytes)
+    {
+        _cache.setMax(maxBytes);
+    }
+
+    ImageCache::~ImageCache()
+    {}
+
+    size_t ImageCache::getMax() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cache.getMax();
+    }
+
+    void ImageCache::setMax(size_t value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cache.setMax(value);
+    }
+
+    size_t ImageCache::getSize() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cache.getSize();
+    }
+
+    bool ImageCache::get(std::size_t hash, OIIO::ImageBuf& value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cache.get(hash, value);
+    }
+
+    void ImageCache::add(std::size_t hash, const OIIO::ImageBuf& value)
+    {
+        const size_t size = value.spec().image_bytes();
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (size > 0 && size <= _cache.getMax())
+        {
+            _cache.add(hash, value, size);
+        }
+    }
+
+    void ImageCache::clear()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cache.clear();
+    }
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <ftk/Core/LRUCache.h>
+
+#include <OpenImageIO/imagebuf.h>
+
+#include <mutex>
+
+namespace toucan
+{
+    //! Image cache.
+    //!
+    //! Rendered images are stored by the hash of the image graph that
+    //! produced them. The cache is limited by the size of the images in
+    //! bytes and can be shared between threads.
+    class ImageCache : public std::enable_shared_from_this<ImageCache>
+    {
+    public:
+        ImageCache(size_t maxBytes = 256 * 1024 * 1024);
+
+        ~ImageCache();
+
+        //! Get the maximum size in bytes.
+        size_t getMax() const;
+
+        //! Set the maximum size in bytes.
+        void setMax(size_t);
+
+        //! Get the current size in bytes.
+        size_t getSize() const;
+
+        //! Get an image.
+        bool get(std::size_t hash, OIIO::ImageBuf&);
+
+        //! Add an image.
+        void add(std::size_t hash, const OIIO::ImageBuf&);
+
+        //! Clear the cache.
+        void clear();
+
+    private:
+        ftk::LRUCache<std::size_t, OIIO::ImageBuf> _cache;
+        mutable std::mutex _mutex;
+    };
+}
@@ -5,125 +5,221 @@
 
 #include <toucanRender/Util.h>
 
+#include <OpenImageIO/parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
 namespace toucan
 {
+    namespace
+    {
+        const int tileRows = 64;
+
+        // The maximum number of idle instances for each set of parameter
+        // names.
+        const size_t instancePoolMax = 16;
+    }
+
     ImageEffectNode::ImageEffectNode(
+        const std::shared_ptr<ImageEffectHost>& host,
         ImageEffectPlugin& plugin,
         const OTIO_NS::AnyDictionary& metaData,
         const std::string& name,
         const std::vector<std::shared_ptr<IImageNode> >& inputs) :
         IImageNode(name, inputs),
+        _host(host),
         _plugin(plugin),
-        _instance(new ImageEffectInstance),
-        _handle{ &plugin, _instance.get() },
         _metaData(metaData)
     {
-        // Set default values.
-        for (const auto& param : _plugin.paramDefs)
+        // Set the parameter values, starting with the defaults.
+        std::map<std::string, std::any> params = _plugin.paramDefaults;
+        for (const auto& i : metaData)
         {
-            auto props = param.second.getStringProperties();
-            auto i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
-            if (i != props.end())
-            {
-                char* s = nullptr;
-                param.second.getString(kOfxParamPropDefault, 0, &s);
-                if (s)
-                {
-                    _instance->params[param.first] = std::string(s);
-                }
-            }
-            props = param.second.getDoubleProperties();
-            i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
-            if (i != props.end())
+            params[i.first] = i.second;
+        }
+
+        // Re-use an instance with the same parameter names from the pool.
+        // Only the values are set, so the handles held by the plugin stay
+        // valid.
+        std::vector<std::string> key;
+        for (const auto& i : params)
+        {
+            key.push_back(i.first);
+        }
+        if (_plugin.instancePool)
+        {
+            std::unique_lock<std::mutex> lock(_plugin.instancePool->mutex);
+            auto i = _plugin.instancePool->instances.find(key);
+            if (i != _plugin.instancePool->instances.end() && !i->second.empty())
             {
-                double d = 0.0;
-                param.second.getDouble(kOfxParamPropDefault, 0, &d);
-                _instance->params[param.first] = d;
+                _instance = std::move(i->second.back());
+                i->second.pop_back();
             }
-            props = param.second.getIntProperties();
-            i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
-            if (i != props.end())
+        }
+        if (_instance)
+        {
+            for (const auto& i : params)
             {
-                int i = 0;
-                param.second.getInt(kOfxParamPropDefault, 0, &i);
-                _instance->params[param.first] = i;
+                _instance->params[i.first] = i.second;
             }
         }
-
-        // Set values.
-        for (const auto& i : metaData)
+        else
         {
-            _instance->params[i.first] = i.second;
+            // Create the plugin instance.
+            _instance.reset(new ImageEffectInstance);
+            _instance->handle = { &plugin, _instance.get() };
+            _instance->params = params;
+            std::unique_lock<std::shared_mutex> lock(*_plugin.mutex);
+            OfxStatus ofxStatus = _plugin.ofxPlugin->mainEntry(
+                kOfxActionCreateInstance,
+                &_instance->handle,
+                nullptr,
+                nullptr);
         }
-
-        // Create the plugin instance.
-        OfxStatus ofxStatus = _plugin.ofxPlugin->mainEntry(
-            kOfxActionCreateInstance,
-            &_handle,
-            nullptr,
-            nullptr);
     }
 
     ImageEffectNode::~ImageEffectNode()
     {
+        // Return the instance to the pool.
+        _instance->images.clear();
+        if (_plugin.instancePool)
+        {
+            std::vector<std::string> key;
+            for (const auto& i : _instance->params)
+            {
+                key.push_back(i.first);
+            }
+            std::unique_lock<std::mutex> lock(_plugin.instancePool->mutex);
+            auto& instances = _plugin.instancePool->instances[key];
+            if (instances.size() < instancePoolMax)
+            {
+                instances.push_back(std::move(_instance));
+                return;
+            }
+        }
+
         // Destroy the plugin instance.
+        std::unique_lock<std::shared_mutex> lock(*_plugin.mutex);
         OfxStatus ofxStatus = _plugin.ofxPlugin->mainEntry(
             kOfxActionDestroyInstance,
-            &_handle,
+            &_instance->handle,
             nullptr,
             nullptr);
     }
 
-    OIIO::ImageBuf ImageEffectNode::exec()
+    void ImageEffectNode::setMetaData(const OTIO_NS::AnyDictionary& value)
+    {
+        _metaData = value;
+        for (const auto& i : value)
+        {
+            _instance->params[i.first] = i.second;
+        }
+    }
+
+    std::size_t ImageEffectNode::getHash() const
+    {
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, hashAny(_metaData));
+        hashCombine(out, std::hash<double>()(_time.value()));
+        return out;
+    }
+
+    OIIO::ROI ImageEffectNode::getRegionOfDefinition() const
     {
+        OIIO::ROI out;
+        const IMATH_NAMESPACE::V2i size = _getSize();
+        if (size.x > 0 && size.y > 0)
+        {
+            out = OIIO::ROI(0, size.x, 0, size.y);
+        }
+        else if (_plugin.context != kOfxImageEffectContextGenerator)
+        {
+            out = IImageNode::getRegionOfDefinition();
+        }
+        return out;
+    }
+
+    bool ImageEffectNode::isOpaque() const
+    {
+        return _evalCached ? _evalOpaque : _isPluginOpaque();
+    }
+
+    OIIO::TypeDesc ImageEffectNode::getFormat() const
+    {
+        return _plugin.context == kOfxImageEffectContextGenerator ?
+            OIIO::TypeDesc(OIIO::TypeDesc::FLOAT) :
+            IImageNode::getFormat();
+    }
+
+    OIIO::ImageBuf ImageEffectNode::_exec()
+    {
+        // Pass the input through without rendering if the plugin is an
+        // identity.
+        const int identity = _getIdentityInput();
+        if (identity >= 0)
+        {
+            return _execInput(identity);
+        }
+
         OIIO::ImageBuf out;
 
         // Initialize the images.
         std::vector<OIIO::ImageBuf> inputs;
-        IMATH_NAMESPACE::V2i size = IMATH_NAMESPACE::V2i(0, 0);
-        auto i = _metaData.find("size");
-        if (i != _metaData.end() && i->second.has_value())
-        {
-            anyToVec(std::any_cast<OTIO_NS::AnyVector>(i->second), size);
-        }
-        char* context = nullptr;
-        _plugin.propSet.getString(kOfxImageEffectPropSupportedContexts, 0, &context);
-        if (strcmp(context, kOfxImageEffectContextGenerator) == 0)
+        const IMATH_NAMESPACE::V2i size = _getSize();
+        const std::string& context = _plugin.context;
+        if (context == kOfxImageEffectContextGenerator)
         {
-            out = OIIO::ImageBuf(OIIO::ImageSpec(size.x, size.y, 4));
+            out = _allocateImage(OIIO::ImageSpec(size.x, size.y, 4));
             _instance->images["Output"] = bufToPropSet(out);
         }
         else if (
-            strcmp(context, kOfxImageEffectContextFilter) == 0 &&
+            context == kOfxImageEffectContextFilter &&
             !_inputs.empty() &&
             _inputs[0])
         {
-            inputs.push_back(_inputs[0]->exec());
+            inputs.push_back(_execInput(0));
             auto spec = inputs[0].spec();
-            if (size.x > 0 && size.y > 0)
+            const bool resize =
+                size.x > 0 &&
+                size.y > 0 &&
+                (size.x != spec.width || size.y != spec.height);
+            if (resize)
             {
                 spec.width = size.x;
                 spec.height = size.y;
             }
-            out = OIIO::ImageBuf(spec);
-            _instance->images["Source"] = bufToPropSet(inputs[0]);
+
+            // Render into the source image if the plugin supports it and
+            // no other node uses the image, instead of allocating a new
+            // image for the output.
+            if (_plugin.supportsInPlace && !resize && _isImageOwned(inputs[0]))
+            {
+                out = std::move(inputs[0]);
+                _instance->images["Source"] = bufToPropSet(out);
+            }
+            else
+            {
+                out = _allocateImage(spec);
+                _instance->images["Source"] = bufToPropSet(inputs[0]);
+            }
             _instance->images["Output"] = bufToPropSet(out);
         }
         else if (
-            strcmp(context, kOfxImageEffectContextTransition) == 0 &&
+            context == kOfxImageEffectContextTransition &&
             _inputs.size() > 1 &&
             _inputs[0] &&
             _inputs[1])
         {
-            inputs.push_back(_inputs[0]->exec());
-            inputs.push_back(_inputs[1]->exec());
+            inputs.push_back(_execInput(0));
+            inputs.push_back(_execInput(1));
             auto spec = inputs[0].spec();
             if (size.x > 0 && size.y > 0)
             {
                 spec.width = size.x;
                 spec.height = size.y;
             }
-            out = OIIO::ImageBuf(spec);
+            out = _allocateImage(spec);
             _instance->images["SourceFrom"] = bufToPropSet(inputs[0]);
             _instance->images["SourceTo"] = bufToPropSet(inputs[1]);
             _instance->images["Output"] = bufToPropSet(out);
@@ -133,22 +229,273 @@ namespace toucan
         const auto& spec = out.spec();
         if (spec.width > 0 && spec.height > 0)
         {
+            OIIO::ROI roi = out.roi();
+            if (_roi.defined() && _plugin.supportsTiles)
+            {
+                roi = OIIO::roi_intersection(_roi, roi);
+            }
+            if (roi.width() > 0 && roi.height() > 0)
+            {
+                // Split the render window into tiles that are rendered in
+                // parallel, if the plugin asks the host to do so and is
+                // safe to render concurrently.
+                std::vector<OfxRectI> tiles;
+                if (_plugin.hostFrameThreading &&
+                    _plugin.supportsTiles &&
+                    _plugin.renderThreadSafety == kOfxImageEffectRenderFullySafe)
+                {
+                    for (int y = roi.ybegin; y < roi.yend; y += tileRows)
+                    {
+                        tiles.push_back({ roi.xbegin, y, roi.xend, std::min(y + tileRows, roi.yend) });
+                    }
+                }
+                else
+                {
+                    tiles.push_back({ roi.xbegin, roi.ybegin, roi.xend, roi.yend });
+                }
+
+                // Plugins that are not safe to render concurrently are
+                // serialized, since branches of the image graph may be
+                // executed on multiple threads.
+                std::shared_lock<std::shared_mutex> sharedLock(*_plugin.mutex, std::defer_lock);
+                std::unique_lock<std::shared_mutex> uniqueLock(*_plugin.mutex, std::defer_lock);
+                if (_plugin.renderThreadSafety == kOfxImageEffectRenderUnsafe)
+                {
+                    uniqueLock.lock();
+                }
+                else
+                {
+                    sharedLock.lock();
+                }
+                if (1 == tiles.size())
+                {
+                    _render(tiles[0]);
+                }
+                else
+                {
+                    OIIO::parallel_for(
+                        int64_t(0),
+                        static_cast<int64_t>(tiles.size()),
+                        [this, &tiles](int64_t i)
+                        {
+                            _render(tiles[i]);
+                        });
+                }
+            }
+        }
+
+        return out;
+    }
+
+    void ImageEffectNode::_render(const OfxRectI& renderWindow)
+    {
+        PropertySet args;
+        args.setDouble(kOfxPropTime, 0, _time.value());
+        args.setIntN(kOfxImageEffectPropRenderWindow, 4, &renderWindow.x1);
+        _plugin.ofxPlugin->mainEntry(
+            kOfxImageEffectActionRender,
+            &_instance->handle,
+            (OfxPropertySetHandle)&args,
+            nullptr);
+    }
+
+    OIIO::ROI ImageEffectNode::_getInputROI(size_t index, const OIIO::ROI& roi) const
+    {
+        OIIO::ROI out = roi;
+        if (!roi.defined() || !_plugin.supportsTiles)
+        {
+            out = OIIO::ROI::All();
+        }
+        else
+        {
+            std::string clip;
+            if (_plugin.context == kOfxImageEffectContextFilter)
+            {
+                clip = "Source";
+            }
+            else if (_plugin.context == kOfxImageEffectContextTransition)
+            {
+                clip = 0 == index ? "SourceFrom" : "SourceTo";
+            }
+
+            // Ask the plugin for the input region. If the plugin does not
+            // reply the input region is the same as the output region.
             PropertySet args;
             args.setDouble(kOfxPropTime, 0, _time.value());
-            OfxRectI bounds;
-            bounds.x1 = 0;
-            bounds.x2 = spec.width;
-            bounds.y1 = 0;
-            bounds.y2 = spec.height;
-            args.setIntN(kOfxImageEffectPropRenderWindow, 4, &bounds.x1);
-
-            _plugin.ofxPlugin->mainEntry(
-                kOfxImageEffectActionRender,
-                &_handle,
-                (OfxPropertySetHandle)&args,
-                nullptr);
+            const double renderScale[] = { 1.0, 1.0 };
+            args.setDoubleN(kOfxImageEffectPropRenderScale, 2, renderScale);
+            const double region[] =
+            {
+                static_cast<double>(roi.xbegin),
+                static_cast<double>(roi.ybegin),
+                static_cast<double>(roi.xend),
+                static_cast<double>(roi.yend)
+            };
+            args.setDoubleN(kOfxImageEffectPropRegionOfInterest, 4, region);
+            PropertySet outArgs;
+            OfxStatus ofxStatus = kOfxStatReplyDefault;
+            {
+                std::shared_lock<std::shared_mutex> lock(*_plugin.mutex);
+                ofxStatus = _plugin.ofxPlugin->mainEntry(
+                    kOfxImageEffectActionGetRegionsOfInterest,
+                    &_instance->handle,
+                    (OfxPropertySetHandle)&args,
+                    (OfxPropertySetHandle)&outArgs);
+            }
+            const std::string name = kOfxImageClipPropRoI + clip;
+            double clipRegion[4] = { 0.0, 0.0, 0.0, 0.0 };
+            if (kOfxStatOK == ofxStatus &&
+                !clip.empty() &&
+                kOfxStatOK == outArgs.getDoubleN(name.c_str(), 4, clipRegion))
+            {
+                out = OIIO::ROI(
+                    static_cast<int>(std::floor(clipRegion[0])),
+                    static_cast<int>(std::ceil(clipRegion[2])),
+                    static_cast<int>(std::floor(clipRegion[1])),
+                    static_cast<int>(std::ceil(clipRegion[3])));
+            }
         }
+        return out;
+    }
+
+    bool ImageEffectNode::_isInputNeeded(size_t index) const
+    {
+        const int identity = _getIdentityInput();
+        return identity < 0 || static_cast<size_t>(identity) == index;
+    }
 
+    IMATH_NAMESPACE::V2i ImageEffectNode::_getSize() const
+    {
+        IMATH_NAMESPACE::V2i out(0, 0);
+        auto i = _metaData.find("size");
+        if (i != _metaData.end() && i->second.has_value())
+        {
+            anyToVec(std::any_cast<OTIO_NS::AnyVector>(i->second), out);
+        }
         return out;
     }
+
+    void ImageEffectNode::_evalBegin()
+    {
+        _evalIdentityInput = _getPluginIdentityInput();
+        _evalOpaque = _isPluginOpaque();
+        _evalCached = true;
+    }
+
+    void ImageEffectNode::_evalEnd()
+    {
+        _evalCached = false;
+    }
+
+    int ImageEffectNode::_getIdentityInput() const
+    {
+        return _evalCached ? _evalIdentityInput : _getPluginIdentityInput();
+    }
+
+    int ImageEffectNode::_getPluginIdentityInput() const
+    {
+        std::vector<std::string> clips;
+        if (_plugin.context == kOfxImageEffectContextFilter &&
+            !_inputs.empty() &&
+            _inputs[0])
+        {
+            clips.push_back("Source");
+        }
+        else if (
+            _plugin.context == kOfxImageEffectContextTransition &&
+            _inputs.size() > 1 &&
+            _inputs[0] &&
+            _inputs[1])
+        {
+            clips.push_back("SourceFrom");
+            clips.push_back("SourceTo");
+        }
+        if (clips.empty())
+        {
+            return -1;
+        }
+
+        // Set the region of definition of the clips, so the plugin can
+        // compare it with its parameters.
+        for (size_t i = 0; i < clips.size(); ++i)
+        {
+            const OIIO::ROI clipROD = _inputs[i]->getRegionOfDefinition();
+            if (clipROD.defined())
+            {
+                const int rect[] = { clipROD.xbegin, clipROD.ybegin, clipROD.xend, clipROD.yend };
+                _instance->images[clips[i]].setIntN(kOfxImagePropRegionOfDefinition, 4, rect);
+            }
+        }
+
+        // Ask the plugin whether it is an identity over the whole output.
+        const OIIO::ROI rod = getRegionOfDefinition();
+        PropertySet args;
+        args.setDouble(kOfxPropTime, 0, _time.value());
+        args.setString(kOfxImageEffectPropFieldToRender, 0, kOfxImageFieldNone);
+        const double renderScale[] = { 1.0, 1.0 };
+        args.setDoubleN(kOfxImageEffectPropRenderScale, 2, renderScale);
+        if (rod.defined())
+        {
+            const int renderWindow[] = { rod.xbegin, rod.ybegin, rod.xend, rod.yend };
+            args.setIntN(kOfxImageEffectPropRenderWindow, 4, renderWindow);
+        }
+        PropertySet outArgs;
+        OfxStatus ofxStatus = kOfxStatReplyDefault;
+        {
+            std::shared_lock<std::shared_mutex> lock(*_plugin.mutex);
+            ofxStatus = _plugin.ofxPlugin->mainEntry(
+                kOfxImageEffectActionIsIdentity,
+                &_instance->handle,
+                (OfxPropertySetHandle)&args,
+                (OfxPropertySetHandle)&outArgs);
+        }
+        char* name = nullptr;
+        if (kOfxStatOK != ofxStatus ||
+            kOfxStatOK != outArgs.getString(kOfxPropName, 0, &name) ||
+            !name)
+        {
+            return -1;
+        }
+        const auto i = std::find(clips.begin(), clips.end(), std::string(name));
+        if (i == clips.end())
+        {
+            return -1;
+        }
+
+        // The input can only be passed through if it has the same size as
+        // the output.
+        const int index = static_cast<int>(i - clips.begin());
+        const IMATH_NAMESPACE::V2i size = _getSize();
+        const OIIO::ROI inputROD = _inputs[index]->getRegionOfDefinition();
+        if ((index > 0 || (size.x > 0 && size.y > 0)) &&
+            (!inputROD.defined() ||
+             inputROD.xbegin != rod.xbegin ||
+             inputROD.ybegin != rod.ybegin ||
+             inputROD.xend != rod.xend ||
+             inputROD.yend != rod.yend))
+        {
+            return -1;
+        }
+        return index;
+    }
+
+    bool ImageEffectNode::_isPluginOpaque() const
+    {
+        PropertySet outArgs;
+        OfxStatus ofxStatus = kOfxStatReplyDefault;
+        {
+            std::shared_lock<std::shared_mutex> lock(*_plugin.mutex);
+            ofxStatus = _plugin.ofxPlugin->mainEntry(
+                kOfxImageEffectActionGetClipPreferences,
+                &_instance->handle,
+                nullptr,
+                (OfxPropertySetHandle)&outArgs);
+        }
+        char* premult = nullptr;
+        return
+            kOfxStatOK == ofxStatus &&
+            kOfxStatOK == outArgs.getString(kOfxImageEffectPropPreMultiplication, 0, &premult) &&
+            premult &&
+            std::string(premult) == kOfxImageOpaque;
+    }
 }
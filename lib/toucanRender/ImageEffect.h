@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <toucanRender/ImageEffectExtensions.h>
 #include <toucanRender/ImageNode.h>
 #include <toucanRender/Plugin.h>
 #include <toucanRender/PropertySet.h>
@@ -11,38 +12,80 @@
 
 #include <opentimelineio/anyDictionary.h>
 
+#include <mutex>
+#include <shared_mutex>
+
 namespace toucan
 {
+    class ImageEffectHost;
+    struct ImageEffectInstance;
+    struct ImageEffectInstancePool;
+
     //! Image effect plugin.
     struct ImageEffectPlugin
     {
         std::shared_ptr<Plugin> plugin;
         OfxPlugin* ofxPlugin = nullptr;
+        std::string context;
+        bool supportsTiles = true;
+        std::string renderThreadSafety = kOfxImageEffectRenderInstanceSafe;
+        bool hostFrameThreading = false;
+        bool supportsInPlace = false;
         PropertySet propSet;
         std::map<std::string, PropertySet> clipPropSets;
         std::map<std::string, std::string> paramTypes;
         std::map<std::string, PropertySet> paramDefs;
+
+        //! The default parameter values, found from the parameter
+        //! definitions when the plugin is initialized.
+        std::map<std::string, std::any> paramDefaults;
+
+        //! Plugins keep per-instance state in shared tables, so instance
+        //! creation and destruction must not overlap with rendering.
+        std::shared_ptr<std::shared_mutex> mutex;
+
+        //! Instances that are not used by a node.
+        std::shared_ptr<ImageEffectInstancePool> instancePool;
+    };
+
+    //! Image effect handle.
+    struct ImageEffectHandle
+    {
+        ImageEffectPlugin* plugin = nullptr;
+        ImageEffectInstance* instance = nullptr;
     };
 
     //! Image effect instance.
     struct ImageEffectInstance
     {
+        //! The handle given to the plugin. Plugins use the address of the
+        //! handle to find their per-instance state.
+        ImageEffectHandle handle;
+
         std::map<std::string, std::any> params;
         std::map<std::string, PropertySet> images;
     };
 
-    //! Image effect handle.
-    struct ImageEffectHandle
+    //! Image effect instance pool.
+    //!
+    //! Image graphs are re-built when the edit segment changes, so instead
+    //! of destroying the plugin instances of the old nodes they are kept
+    //! for the new nodes. Plugins hold handles to the parameter values, so
+    //! instances are only re-used for the same parameter names.
+    struct ImageEffectInstancePool
     {
-        ImageEffectPlugin* plugin = nullptr;
-        ImageEffectInstance* instance = nullptr;
+        std::map<std::vector<std::string>, std::vector<std::unique_ptr<ImageEffectInstance> > > instances;
+        std::mutex mutex;
     };
 
     //! Image effect node.
     class ImageEffectNode : public IImageNode
     {
     public:
+        //! The node keeps the host alive, since the plugin is unloaded
+        //! when the host is destroyed.
         ImageEffectNode(
+            const std::shared_ptr<ImageEffectHost>&,
             ImageEffectPlugin&,
             const OTIO_NS::AnyDictionary& metaData,
             const std::string& name,
@@ -50,12 +93,58 @@ namespace toucan
 
         virtual ~ImageEffectNode();
 
-        OIIO::ImageBuf exec() override;
+        //! Set the metadata. The parameters are updated with the new
+        //! values, so the node can be re-used instead of creating a new
+        //! plugin instance.
+        void setMetaData(const OTIO_NS::AnyDictionary&);
+
+        std::size_t getHash() const override;
+        OIIO::ROI getRegionOfDefinition() const override;
+
+        //! The image is opaque if the plugin sets the pre-multiplication
+        //! of the output clip to opaque.
+        bool isOpaque() const override;
+
+        //! Generators render floating point images, filters and
+        //! transitions use the format of the first input.
+        OIIO::TypeDesc getFormat() const override;
+
+    protected:
+        OIIO::ImageBuf _exec() override;
+        OIIO::ROI _getInputROI(size_t, const OIIO::ROI&) const override;
+
+        //! Only the input that is passed through is needed when the
+        //! plugin is an identity.
+        bool _isInputNeeded(size_t) const override;
+
+        //! Whether the plugin is an identity and whether the image is
+        //! opaque are found once for each evaluation, since the graph
+        //! queries them many times.
+        void _evalBegin() override;
+        void _evalEnd() override;
 
     private:
+        IMATH_NAMESPACE::V2i _getSize() const;
+
+        //! Get the index of the input that is passed through unchanged,
+        //! or -1 if the plugin is not an identity.
+        int _getIdentityInput() const;
+
+        //! Ask the plugin whether it is an identity.
+        int _getPluginIdentityInput() const;
+
+        //! Ask the plugin whether the image is opaque.
+        bool _isPluginOpaque() const;
+
+        void _render(const OfxRectI&);
+
+        std::shared_ptr<ImageEffectHost> _host;
         ImageEffectPlugin& _plugin;
         std::unique_ptr<ImageEffectInstance> _instance;
-        ImageEffectHandle _handle;
         OTIO_NS::AnyDictionary _metaData;
+
+        bool _evalCached = false;
+        int _evalIdentityInput = -1;
+        bool _evalOpaque = false;
     };
 }
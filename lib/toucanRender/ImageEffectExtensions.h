@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+// Toucan extensions to the OpenFX image effect API, shared by the host
+// and the plugins.
+
+//! Toucan extension: set to 1 by plugins that can render with the same
+//! image for the source and output clips.
+#define kToucanImageEffectPropSupportsInPlace "ToucanImageEffectPropSupportsInPlace"
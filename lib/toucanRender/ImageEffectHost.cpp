@@ -7,6 +7,7 @@
 
 #include <ftk/Core/LogSystem.h>
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstring>
 #include <iostream>
@@ -35,8 +36,26 @@ namespace toucan
 
     ImageEffectHost::~ImageEffectHost()
     {
-        for (const auto& plugin : _plugins)
+        for (auto& plugin : _plugins)
         {
+            // Destroy the pooled instances.
+            if (plugin.instancePool)
+            {
+                std::unique_lock<std::mutex> lock(plugin.instancePool->mutex);
+                for (auto& i : plugin.instancePool->instances)
+                {
+                    for (auto& instance : i.second)
+                    {
+                        OfxStatus ofxStatus = plugin.ofxPlugin->mainEntry(
+                            kOfxActionDestroyInstance,
+                            &instance->handle,
+                            nullptr,
+                            nullptr);
+                    }
+                }
+                plugin.instancePool->instances.clear();
+            }
+
             OfxStatus ofxStatus = plugin.ofxPlugin->mainEntry(
                 kOfxActionUnload,
                 nullptr,
@@ -51,13 +70,15 @@ namespace toucan
         const std::vector<std::shared_ptr<IImageNode> >& inputs)
     {
         std::shared_ptr<IImageNode> out;
-        for (auto& plugin : _plugins)
+        const auto i = _pluginIndex.find(name);
+        if (i != _pluginIndex.end())
         {
-            if (name == plugin.ofxPlugin->pluginIdentifier)
-            {
-                out = std::make_shared<ImageEffectNode>(plugin, metaData, name, inputs);
-                break;
-            }
+            out = std::make_shared<ImageEffectNode>(
+                shared_from_this(),
+                _plugins[i->second],
+                metaData,
+                name,
+                inputs);
         }
         return out;
     }
@@ -95,6 +116,7 @@ namespace toucan
         _effectSuite.clipGetHandle = &_clipGetHandle;
         _effectSuite.clipGetImage = &_clipGetImage;
         _effectSuite.clipReleaseImage = &_clipReleaseImage;
+        _effectSuite.clipGetRegionOfDefinition = &_clipGetRegionOfDefinition;
     }
 
     void ImageEffectHost::_pluginInit(const std::vector<std::filesystem::path>& searchPath)
@@ -148,8 +170,15 @@ namespace toucan
                         {
                         case kOfxStatOK:
                         case kOfxStatReplyDefault:
-                            _plugins.push_back({ plugin, ofxPlugin });
+                        {
+                            ImageEffectPlugin imageEffectPlugin;
+                            imageEffectPlugin.plugin = plugin;
+                            imageEffectPlugin.ofxPlugin = ofxPlugin;
+                            imageEffectPlugin.mutex = std::make_shared<std::shared_mutex>();
+                            imageEffectPlugin.instancePool = std::make_shared<ImageEffectInstancePool>();
+                            _plugins.push_back(imageEffectPlugin);
                             break;
+                        }
                         case kOfxStatErrFatal:
                         {
                             std::stringstream ss;
@@ -188,6 +217,21 @@ namespace toucan
                 &handle,
                 nullptr,
                 nullptr);
+            int supportsTiles = 1;
+            plugin.propSet.getInt(kOfxImageEffectPropSupportsTiles, 0, &supportsTiles);
+            plugin.supportsTiles = supportsTiles != 0;
+            char* renderThreadSafety = nullptr;
+            plugin.propSet.getString(kOfxImageEffectPluginRenderThreadSafety, 0, &renderThreadSafety);
+            if (renderThreadSafety)
+            {
+                plugin.renderThreadSafety = renderThreadSafety;
+            }
+            int hostFrameThreading = 0;
+            plugin.propSet.getInt(kOfxImageEffectPluginPropHostFrameThreading, 0, &hostFrameThreading);
+            plugin.hostFrameThreading = hostFrameThreading != 0;
+            int supportsInPlace = 0;
+            plugin.propSet.getInt(kToucanImageEffectPropSupportsInPlace, 0, &supportsInPlace);
+            plugin.supportsInPlace = supportsInPlace != 0;
             int contextCount = 0;
             plugin.propSet.getDimension(kOfxImageEffectPropSupportedContexts, &contextCount);
             for (int i = 0; i < contextCount; ++i)
@@ -196,6 +240,10 @@ namespace toucan
                 plugin.propSet.getString(kOfxImageEffectPropSupportedContexts, i, &context);
                 if (context)
                 {
+                    if (plugin.context.empty())
+                    {
+                        plugin.context = context;
+                    }
                     PropertySet propSet;
                     propSet.setString(kOfxImageEffectPropContext, 0, context);
                     {
@@ -216,6 +264,44 @@ namespace toucan
                 ss << "    \"" << param.first << "\": " << param.second;
                 logSystem->print(logPrefix, ss.str());
             }
+
+            // Find the default parameter values.
+            for (const auto& param : plugin.paramDefs)
+            {
+                auto props = param.second.getStringProperties();
+                auto i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
+                if (i != props.end())
+                {
+                    char* s = nullptr;
+                    param.second.getString(kOfxParamPropDefault, 0, &s);
+                    if (s)
+                    {
+                        plugin.paramDefaults[param.first] = std::string(s);
+                    }
+                }
+                props = param.second.getDoubleProperties();
+                i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
+                if (i != props.end())
+                {
+                    double d = 0.0;
+                    param.second.getDouble(kOfxParamPropDefault, 0, &d);
+                    plugin.paramDefaults[param.first] = d;
+                }
+                props = param.second.getIntProperties();
+                i = std::find(props.begin(), props.end(), kOfxParamPropDefault);
+                if (i != props.end())
+                {
+                    int i = 0;
+                    param.second.getInt(kOfxParamPropDefault, 0, &i);
+                    plugin.paramDefaults[param.first] = i;
+                }
+            }
+        }
+
+        // Index the plugins by their identifier.
+        for (size_t i = 0; i < _plugins.size(); ++i)
+        {
+            _pluginIndex.insert({ _plugins[i].ofxPlugin->pluginIdentifier, i });
         }
     }
 
@@ -349,4 +435,22 @@ namespace toucan
     {
         return kOfxStatOK;
     }
+
+    OfxStatus ImageEffectHost::_clipGetRegionOfDefinition(OfxImageClipHandle handle, OfxTime, OfxRectD* bounds)
+    {
+        // The region of definition is set by the node before the identity
+        // action, otherwise the bounds of the current image are used.
+        PropertySet* propSet = (PropertySet*)handle;
+        int rect[4] = { 0, 0, 0, 0 };
+        if (kOfxStatOK != propSet->getIntN(kOfxImagePropRegionOfDefinition, 4, rect) &&
+            kOfxStatOK != propSet->getIntN(kOfxImagePropBounds, 4, rect))
+        {
+            return kOfxStatFailed;
+        }
+        bounds->x1 = rect[0];
+        bounds->y1 = rect[1];
+        bounds->x2 = rect[2];
+        bounds->y2 = rect[3];
+        return kOfxStatOK;
+    }
 }
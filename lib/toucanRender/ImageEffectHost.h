@@ -10,6 +10,7 @@
 #include <OpenImageIO/imagebuf.h>
 
 #include <filesystem>
+#include <unordered_map>
 
 namespace toucan
 {
@@ -42,6 +43,7 @@ namespace toucan
         static OfxStatus _clipDefine(OfxImageEffectHandle, const char* name, OfxPropertySetHandle*);
         static OfxStatus _clipGetHandle(OfxImageEffectHandle, const char* name, OfxImageClipHandle*, OfxPropertySetHandle*);
         static OfxStatus _clipGetImage(OfxImageClipHandle, OfxTime, const OfxRectD*, OfxPropertySetHandle*);
+        static OfxStatus _clipGetRegionOfDefinition(OfxImageClipHandle, OfxTime, OfxRectD*);
         static OfxStatus _clipReleaseImage(OfxPropertySetHandle);
 
         std::weak_ptr<ftk::Context> _context;
@@ -51,5 +53,6 @@ namespace toucan
         OfxParameterSuiteV1 _parameterSuite;
         OfxImageEffectSuiteV1 _effectSuite;
         std::vector<ImageEffectPlugin> _plugins;
+        std::unordered_map<std::string, size_t> _pluginIndex;
     };
 }
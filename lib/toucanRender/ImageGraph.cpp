@@ -4,6 +4,8 @@
 #include "ImageGraph.h"
 
 #include "Comp.h"
+#include "Constant.h"
+#include "ImageEffect.h"
 #include "ImageEffectHost.h"
 #include "Read.h"
 #include "TimeWarp.h"
@@ -19,6 +21,8 @@
 #include <opentimelineio/imageSequenceReference.h>
 #include <opentimelineio/linearTimeWarp.h>
 
+#include <algorithm>
+
 namespace toucan
 {
     namespace
@@ -39,6 +43,26 @@ namespace toucan
         }
     }
 
+    ImageGraphContext::ImageGraphContext()
+    {}
+
+    ImageGraphContext::~ImageGraphContext()
+    {
+        if (_mediaPool)
+        {
+            for (const auto& i : _reads)
+            {
+                _mediaPool->checkIn(i.second.key, i.second.read);
+            }
+        }
+    }
+
+    void ImageGraphContext::setReadAhead(size_t value, int direction)
+    {
+        _readAhead = value;
+        _readAheadDirection = direction;
+    }
+
     ImageGraph::ImageGraph(
         const std::shared_ptr<ftk::Context>& context,
         const std::filesystem::path& path,
@@ -46,19 +70,28 @@ namespace toucan
         _context(context),
         _path(path),
         _timelineWrapper(timelineWrapper),
-        _timeRange(timelineWrapper->getTimeRange())
+        _timeRange(timelineWrapper->getTimeRange()),
+        _mediaPool(MediaPool::get())
     {
-        _readCache.setMax(20);
+        _mutex.imageCache = std::make_shared<ImageCache>();
 
         // Get the image information from the first video clip.
         for (auto clip : getVideoClips(_timelineWrapper->getTimeline()))
         {
             if (auto externalRef = dynamic_cast<OTIO_NS::ExternalReference*>(clip->media_reference()))
             {
+                // The read node is checked back in to the media pool, so
+                // it can be re-used when the graph is executed.
+                const std::string key = _timelineWrapper->getMediaKey(externalRef);
                 std::shared_ptr<IReadNode> read;
                 try
                 {
-                    read = _timelineWrapper->createReadNode(externalRef);
+                    read = _mediaPool->checkOut(
+                        key,
+                        [this, externalRef]
+                        {
+                            return _timelineWrapper->createReadNode(externalRef);
+                        });
                 }
                 catch (const std::exception& e)
                 {
@@ -69,23 +102,33 @@ namespace toucan
                 }
                 if (read)
                 {
-                    const auto& spec = read->getSpec();
+                    const auto spec = read->getSpec();
+                    _mediaPool->checkIn(key, read);
                     if (spec.width > 0)
                     {
                         _imageSize.x = spec.width;
                         _imageSize.y = spec.height;
                         _imageChannels = spec.nchannels;
                         _imageDataType = toImageDataType(spec.format);
+                        _imageFormat = spec.format;
                         break;
                     }
                 }
             }
             else if (auto sequenceRef = dynamic_cast<OTIO_NS::ImageSequenceReference*>(clip->media_reference()))
             {
+                // The read node is checked back in to the media pool, so
+                // it can be re-used when the graph is executed.
+                const std::string key = _timelineWrapper->getMediaKey(sequenceRef);
                 std::shared_ptr<IReadNode> read;
                 try
                 {
-                    read = _timelineWrapper->createReadNode(sequenceRef);
+                    read = _mediaPool->checkOut(
+                        key,
+                        [this, sequenceRef]
+                        {
+                            return _timelineWrapper->createReadNode(sequenceRef);
+                        });
                 }
                 catch (const std::exception& e)
                 {
@@ -96,13 +139,15 @@ namespace toucan
                 }
                 if (read)
                 {
-                    const auto& spec = read->getSpec();
+                    const auto spec = read->getSpec();
+                    _mediaPool->checkIn(key, read);
                     if (spec.width > 0)
                     {
                         _imageSize.x = spec.width;
                         _imageSize.y = spec.height;
                         _imageChannels = spec.nchannels;
                         _imageDataType = toImageDataType(spec.format);
+                        _imageFormat = spec.format;
                         break;
                     }
                 }
@@ -117,10 +162,13 @@ namespace toucan
                     //! \bug Hard coded:
                     _imageChannels = 4;
                     _imageDataType = toImageDataType(OIIO::TypeDesc::UINT8);
+                    _imageFormat = OIIO::TypeDesc::UINT8;
                     break;
                 }
             }
         }
+
+        _index();
     }
 
     ImageGraph::~ImageGraph()
@@ -141,189 +189,418 @@ namespace toucan
         return _imageDataType;
     }
 
+    OIIO::ImageSpec ImageGraph::getImageSpec() const
+    {
+        return OIIO::ImageSpec(_imageSize.x, _imageSize.y, _imageChannels, _imageFormat);
+    }
+
+    std::shared_ptr<ImageCache> ImageGraph::getImageCache() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.imageCache;
+    }
+
+    void ImageGraph::setImageCache(const std::shared_ptr<ImageCache>& value)
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        _mutex.imageCache = value;
+    }
+
+    void ImageGraph::setReadAhead(size_t value, int direction)
+    {
+        _defaultContext.setReadAhead(value, direction);
+    }
+
     std::shared_ptr<IImageNode> ImageGraph::exec(
         const std::shared_ptr<ImageEffectHost>& host,
         const OTIO_NS::RationalTime& time,
         const OTIO_NS::Item* itemNode)
     {
-        _host = host;
-        _itemNode = itemNode;
+        return exec(_defaultContext, host, time, itemNode);
+    }
 
-        // Set the background color.
-        OTIO_NS::AnyDictionary metaData;
-        metaData["size"] = vecToAny(_imageSize);
-        metaData["color"] = vecToAny(IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 1.F));
-        auto node = host->createNode(metaData, "toucan:Fill");
+    std::shared_ptr<IImageNode> ImageGraph::exec(
+        ImageGraphContext& context,
+        const std::shared_ptr<ImageEffectHost>& host,
+        const OTIO_NS::RationalTime& time,
+        const OTIO_NS::Item* itemNode)
+    {
+        Exec exec;
+        exec.context = &context;
+        exec.host = host;
+        exec.itemNode = itemNode;
+        context._hints.resize(_tracks.size(), 0);
 
         // Apply time warps.
         auto stack = _timelineWrapper->getTimeline()->tracks();
         const auto& stackEffects = stack->effects();
         OTIO_NS::RationalTime t = time - _timeRange.start_time();
-        t = _timeWarps(t, stack->available_range(), stackEffects);
+        t = _timeWarps(t, _stackAvailableRange, stackEffects);
+
+        // Re-use the nodes from the previous frame if it is in the same
+        // edit segment.
+        const std::vector<int> segment = _getSegment(exec, t);
+        if (segment != context._segment)
+        {
+            context._segment = segment;
+            context._segmentNodes.clear();
+        }
+
+        // Set the background color.
+        auto node = _createConstant(
+            exec,
+            _imageSize,
+            IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 1.F));
 
         // Loop over the tracks.
+        for (size_t i = 0; i < _tracks.size(); ++i)
+        {
+            // Apply time warps.
+            const auto& trackEffects = _tracks[i].track->effects();
+            const OTIO_NS::RationalTime t2 = _trackTime(t, _tracks[i]);
+
+            // Process this track.
+            auto trackNode = _track(exec, t2, i);
+
+            // Add the track effects.
+            trackNode = _effects(exec, t2, trackEffects, trackNode);
+
+            // Composite this track over the previous track.
+            std::vector<std::shared_ptr<IImageNode> > nodes;
+            if (trackNode)
+            {
+                nodes.push_back(trackNode);
+            }
+            if (node)
+            {
+                nodes.push_back(node);
+            }
+            node = _createComp(exec, nodes);
+        }
+
+        // Add the stack effects.
+        node = _effects(exec, t, stackEffects, node);
+
+        context._segmentNodes = std::move(exec.segmentNodes);
+
+        // Check in the read nodes that are no longer used.
+        for (auto i = context._reads.begin(); i != context._reads.end();)
+        {
+            if (exec.reads.find(i->first) == exec.reads.end())
+            {
+                context._mediaPool->checkIn(i->second.key, i->second.read);
+                i = context._reads.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        if (exec.outNode)
+        {
+            node = exec.outNode;
+        }
+
+        // Use the cached image if the graph has already been rendered.
+        if (node)
+        {
+            node->setImageCache(getImageCache());
+        }
+
+        return node;
+    }
+
+    void ImageGraph::_index()
+    {
+        auto stack = _timelineWrapper->getTimeline()->tracks();
+        _stackAvailableRange = stack->available_range();
         for (const auto& i : stack->children())
         {
-            if (auto track = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Track>(i))
+            auto track = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Track>(i);
+            if (!track ||
+                track->kind() != OTIO_NS::Track::Kind::video ||
+                track->find_clips().empty())
             {
-                if (track->kind() == OTIO_NS::Track::Kind::video && !track->find_clips().empty())
+                continue;
+            }
+
+            TrackEntry entry;
+            entry.track = track;
+            entry.availableRange = track->available_range();
+
+            // Get the ranges of the children in one pass, and trim them to
+            // the track's source range.
+            const auto ranges = track->range_of_all_children();
+            const auto& sourceRange = track->source_range();
+            const auto& children = track->children();
+            std::vector<int> itemIndices(children.size(), -1);
+            std::vector<int> transitionIndices(children.size(), -1);
+            for (size_t j = 0; j < children.size(); ++j)
+            {
+                const auto k = ranges.find(children[j].value);
+                if (k == ranges.end())
+                {
+                    continue;
+                }
+                const OTIO_NS::TimeRange& rangeOfChild = k->second;
+                OTIO_NS::TimeRange range = rangeOfChild;
+                if (sourceRange.has_value())
                 {
-                    // Apply time warps.
-                    const auto& trackEffects = track->effects();
-                    OTIO_NS::RationalTime t2 = t;
-                    if (!trackEffects.empty())
+                    const OTIO_NS::RationalTime start = std::max(
+                        sourceRange->start_time(),
+                        rangeOfChild.start_time());
+                    if (start >= rangeOfChild.end_time_exclusive())
                     {
-                        t2 = _timeWarps(t2, track->available_range(), trackEffects);
+                        continue;
                     }
+                    const OTIO_NS::RationalTime end = std::min(
+                        rangeOfChild.end_time_exclusive(),
+                        sourceRange->end_time_exclusive());
+                    range = OTIO_NS::TimeRange(start, end - start);
+                }
+                if (auto item = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Item>(children[j]))
+                {
+                    ItemEntry itemEntry;
+                    itemEntry.range = range;
+                    itemEntry.rangeStart = rangeOfChild.start_time();
+                    itemEntry.trimmedStart = item->trimmed_range().start_time();
+                    itemEntry.item = item;
+                    itemIndices[j] = static_cast<int>(entry.items.size());
+                    entry.items.push_back(itemEntry);
+                }
+                else if (auto transition = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Transition>(children[j]))
+                {
+                    TransitionEntry transitionEntry;
+                    transitionEntry.range = range;
+                    transitionEntry.transition = transition;
+                    transitionIndices[j] = static_cast<int>(entry.transitions.size());
+                    entry.transitions.push_back(transitionEntry);
+                }
+            }
 
-                    // Process this track.
-                    auto trackNode = _track(t2, track);
+            // Link the items to their neighboring transitions.
+            for (size_t j = 0; j < children.size(); ++j)
+            {
+                if (itemIndices[j] < 0)
+                {
+                    continue;
+                }
+                ItemEntry& itemEntry = entry.items[itemIndices[j]];
+                if (j > 1 && transitionIndices[j - 1] >= 0)
+                {
+                    itemEntry.prevTransition = transitionIndices[j - 1];
+                    itemEntry.prevItem = itemIndices[j - 2];
+                }
+                if (j + 2 < children.size() && transitionIndices[j + 1] >= 0)
+                {
+                    itemEntry.nextTransition = transitionIndices[j + 1];
+                    itemEntry.nextItem = itemIndices[j + 2];
+                }
+            }
 
-                    // Add the track effects.
-                    trackNode = _effects(t2, trackEffects, trackNode);
+            _tracks.push_back(std::move(entry));
+        }
+    }
 
-                    // Composite this track over the previous track.
-                    std::vector<std::shared_ptr<IImageNode> > nodes;
-                    if (trackNode)
-                    {
-                        nodes.push_back(trackNode);
-                    }
-                    if (node)
-                    {
-                        nodes.push_back(node);
-                    }
-                    auto comp = std::make_shared<CompNode>(nodes);
-                    comp->setPremult(true);
-                    node = comp;
-                }
+    OTIO_NS::RationalTime ImageGraph::_trackTime(
+        const OTIO_NS::RationalTime& time,
+        const TrackEntry& track) const
+    {
+        OTIO_NS::RationalTime out = time;
+        const auto& effects = track.track->effects();
+        if (!effects.empty())
+        {
+            out = _timeWarps(out, track.availableRange, effects);
+        }
+        return out;
+    }
+
+    std::vector<int> ImageGraph::_getSegment(
+        Exec& exec,
+        const OTIO_NS::RationalTime& time) const
+    {
+        // The segment is identified by the active item in each track, and
+        // whether the transitions on either side of it are active.
+        std::vector<int> out;
+        out.reserve(_tracks.size() * 3);
+        for (size_t i = 0; i < _tracks.size(); ++i)
+        {
+            const TrackEntry& track = _tracks[i];
+            const OTIO_NS::RationalTime t = _trackTime(time, track);
+            const ItemEntry* entry = _findItem(track, exec.context->_hints[i], t);
+            out.push_back(entry ? static_cast<int>(entry - track.items.data()) : -1);
+            out.push_back(
+                entry &&
+                entry->prevTransition >= 0 &&
+                track.transitions[entry->prevTransition].range.contains(t));
+            out.push_back(
+                entry &&
+                entry->nextTransition >= 0 &&
+                track.transitions[entry->nextTransition].range.contains(t));
+        }
+        return out;
+    }
+
+    std::shared_ptr<IImageNode> ImageGraph::_reuseNode(
+        Exec& exec,
+        const std::string& name,
+        const std::vector<std::shared_ptr<IImageNode> >& inputs) const
+    {
+        std::shared_ptr<IImageNode> out;
+        const auto& nodes = exec.context->_segmentNodes;
+        if (exec.segmentIndex < nodes.size())
+        {
+            auto node = nodes[exec.segmentIndex];
+            if (node && node->getName() == name)
+            {
+                out = node;
+                out->setInputs(inputs);
             }
         }
+        ++exec.segmentIndex;
+        return out;
+    }
 
-        // Add the stack effects.
-        node = _effects(t, stackEffects, node);
+    std::shared_ptr<IImageNode> ImageGraph::_createNode(
+        Exec& exec,
+        const OTIO_NS::AnyDictionary& metaData,
+        const std::string& name,
+        const std::vector<std::shared_ptr<IImageNode> >& inputs) const
+    {
+        std::shared_ptr<IImageNode> out = _reuseNode(exec, name, inputs);
+        if (auto imageEffect = std::dynamic_pointer_cast<ImageEffectNode>(out))
+        {
+            imageEffect->setMetaData(metaData);
+        }
+        else
+        {
+            out = exec.host->createNode(metaData, name, inputs);
+        }
+        exec.segmentNodes.push_back(out);
+        return out;
+    }
 
-        // Clean up.
-        _host.reset();
-        _itemNode = nullptr;
-        if (_outNode)
+    std::shared_ptr<IImageNode> ImageGraph::_createConstant(
+        Exec& exec,
+        const IMATH_NAMESPACE::V2i& size,
+        const IMATH_NAMESPACE::V4f& color) const
+    {
+        auto out = std::dynamic_pointer_cast<ConstantNode>(_reuseNode(exec, "Constant", {}));
+        if (out)
+        {
+            out->setSize(size);
+            out->setColor(color);
+        }
+        else
         {
-            node = _outNode;
+            out = std::make_shared<ConstantNode>(size, color);
         }
-        _outNode.reset();
+        exec.segmentNodes.push_back(out);
+        return out;
+    }
 
-        return node;
+    std::shared_ptr<IImageNode> ImageGraph::_createComp(
+        Exec& exec,
+        const std::vector<std::shared_ptr<IImageNode> >& inputs) const
+    {
+        // Compositing a transparent image does not change the background.
+        if (inputs.size() > 1)
+        {
+            auto constant = std::dynamic_pointer_cast<ConstantNode>(inputs[0]);
+            if (constant && constant->isTransparent())
+            {
+                return inputs[1];
+            }
+        }
+
+        std::shared_ptr<IImageNode> out = _reuseNode(exec, "Comp", inputs);
+        if (!out)
+        {
+            auto comp = std::make_shared<CompNode>(inputs);
+            comp->setPremult(true);
+            out = comp;
+        }
+        exec.segmentNodes.push_back(out);
+        return out;
+    }
+
+    const ImageGraph::ItemEntry* ImageGraph::_findItem(
+        const TrackEntry& track,
+        size_t& hint,
+        const OTIO_NS::RationalTime& time) const
+    {
+        const auto& items = track.items;
+
+        // Check the last item found and the one after it first, which is
+        // the common case for sequential playback.
+        for (size_t i = hint; i < items.size() && i < hint + 2; ++i)
+        {
+            if (items[i].range.contains(time))
+            {
+                hint = i;
+                return &items[i];
+            }
+        }
+
+        // Search the sorted ranges.
+        auto i = std::upper_bound(
+            items.begin(),
+            items.end(),
+            time,
+            [](const OTIO_NS::RationalTime& value, const ItemEntry& item)
+            {
+                return value < item.range.start_time();
+            });
+        if (i != items.begin())
+        {
+            --i;
+            if (i->range.contains(time))
+            {
+                hint = i - items.begin();
+                return &*i;
+            }
+        }
+        return nullptr;
     }
 
     std::shared_ptr<IImageNode> ImageGraph::_track(
+        Exec& exec,
         const OTIO_NS::RationalTime& time,
-        const OTIO_NS::SerializableObject::Retainer<OTIO_NS::Track>& track)
+        size_t index)
     {
         std::shared_ptr<IImageNode> out;
 
-        // Find the item for the given time. The previous and next items are
-        // also tracked for handling transitions.
-        OTIO_NS::SerializableObject::Retainer<OTIO_NS::Item> item;
-        OTIO_NS::SerializableObject::Retainer<OTIO_NS::Composable> prev;
-        OTIO_NS::SerializableObject::Retainer<OTIO_NS::Composable> prev2;
-        OTIO_NS::SerializableObject::Retainer<OTIO_NS::Composable> next;
-        OTIO_NS::SerializableObject::Retainer<OTIO_NS::Composable> next2;
-        const auto& children = track->children();
-        for (size_t i = 0; i < children.size(); ++i)
+        // Find the item for the given time.
+        const TrackEntry& track = _tracks[index];
+        const ItemEntry* entry = _findItem(track, exec.context->_hints[index], time);
+        if (!entry)
         {
-            if ((item = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Item>(children[i])))
-            {
-                const auto trimmedRangeInParent = item->trimmed_range_in_parent();
-                if (trimmedRangeInParent.has_value() && trimmedRangeInParent.value().contains(time))
-                {
-                    out = _item(
-                        track->transformed_time(time, item),
-                        item);
-                    if (i > 0)
-                    {
-                        prev = children[i - 1];
-                    }
-                    if (i > 1)
-                    {
-                        prev2 = children[i - 2];
-                    }
-                    if (i < (children.size() - 1))
-                    {
-                        next = children[i + 1];
-                    }
-                    if (children.size() > 1 && i < (children.size() - 2))
-                    {
-                        next2 = children[i + 2];
-                    }
-                    break;
-                }
-            }
+            return out;
         }
+        out = _item(exec, time - entry->rangeStart + entry->trimmedStart, entry->item);
 
         // Handle transitions.
-        if (item && out)
+        if (out)
         {
-            if (auto prevTransition = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Transition>(prev))
+            if (entry->prevTransition >= 0 && entry->prevItem >= 0)
             {
-                const auto trimmedRangeInParent = prevTransition->trimmed_range_in_parent();
-                if (trimmedRangeInParent.has_value() && trimmedRangeInParent.value().contains(time))
+                const auto& transition = track.transitions[entry->prevTransition];
+                if (transition.range.contains(time))
                 {
-                    if (auto prevItem = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Item>(prev2))
-                    {
-                        const double value =
-                            (time - trimmedRangeInParent.value().start_time()).value() /
-                            trimmedRangeInParent.value().duration().value();
-
-                        auto a = _item(
-                            track->transformed_time(time, prevItem),
-                            prevItem);
-
-                        auto metaData = prevTransition->metadata();
-                        metaData["value"] = value;
-                        auto node = _host->createNode(
-                            metaData,
-                            prevTransition->transition_type(),
-                            { a, out });
-                        if (!node)
-                        {
-                            node = _host->createNode(
-                                metaData,
-                                "toucan:Dissolve",
-                                { a, out });
-                        }
-                        out = node;
-                    }
+                    const auto& prev = track.items[entry->prevItem];
+                    auto a = _item(exec, time - prev.rangeStart + prev.trimmedStart, prev.item);
+                    out = _transition(exec, time, transition, { a, out });
                 }
             }
-            if (auto nextTransition = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Transition>(next))
+            if (entry->nextTransition >= 0 && entry->nextItem >= 0)
             {
-                const auto trimmedRangeInParent = nextTransition->trimmed_range_in_parent();
-                if (trimmedRangeInParent.has_value() && trimmedRangeInParent.value().contains(time))
+                const auto& transition = track.transitions[entry->nextTransition];
+                if (transition.range.contains(time))
                 {
-                    if (auto nextItem = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Item>(next2))
-                    {
-                        const double value =
-                            (time - trimmedRangeInParent.value().start_time()).value() /
-                            trimmedRangeInParent.value().duration().value();
-
-                        auto b = _item(
-                            track->transformed_time(time, nextItem),
-                            nextItem);
-
-                        auto metaData = nextTransition->metadata();
-                        metaData["value"] = value;
-                        auto node = _host->createNode(
-                            metaData,
-                            nextTransition->transition_type(),
-                            { out, b });
-                        if (!node)
-                        {
-                            node = _host->createNode(
-                                metaData,
-                                "toucan:Dissolve",
-                                { out, b });
-                        }
-                        out = node;
-                    }
+                    const auto& next = track.items[entry->nextItem];
+                    auto b = _item(exec, time - next.rangeStart + next.trimmedStart, next.item);
+                    out = _transition(exec, time, transition, { out, b });
                 }
             }
         }
@@ -331,7 +608,35 @@ namespace toucan
         return out;
     }
 
+    std::shared_ptr<IImageNode> ImageGraph::_transition(
+        Exec& exec,
+        const OTIO_NS::RationalTime& time,
+        const TransitionEntry& transition,
+        const std::vector<std::shared_ptr<IImageNode> >& inputs) const
+    {
+        const double value =
+            (time - transition.range.start_time()).value() /
+            transition.range.duration().value();
+        auto metaData = transition.transition->metadata();
+        metaData["value"] = value;
+        auto out = _createNode(
+            exec,
+            metaData,
+            transition.transition->transition_type(),
+            inputs);
+        if (!out)
+        {
+            out = _createNode(
+                exec,
+                metaData,
+                "toucan:Dissolve",
+                inputs);
+        }
+        return out;
+    }
+
     std::shared_ptr<IImageNode> ImageGraph::_item(
+        Exec& exec,
         const OTIO_NS::RationalTime& time,
         const OTIO_NS::SerializableObject::Retainer<OTIO_NS::Item>& item)
     {
@@ -349,24 +654,12 @@ namespace toucan
             auto mediaRef = clip->media_reference();
             if (auto externalRef = dynamic_cast<OTIO_NS::ExternalReference*>(mediaRef))
             {
-                std::shared_ptr<IReadNode> read;
-                if (!_readCache.get(externalRef, read))
-                {
-                    try
-                    {
-                        read = _timelineWrapper->createReadNode(externalRef);
-                        _readCache.add(externalRef, read);
-                    }
-                    catch (const std::exception& e)
-                    {
-                        _context.lock()->getSystem<ftk::LogSystem>()->print(
-                            logPrefix,
-                            e.what(),
-                            ftk::LogType::Error);
-                    }
-                }
-                if (read)
+                if (auto read = _getReadNode(exec, externalRef))
                 {
+                    read->setReadAhead(
+                        exec.context->_readAhead,
+                        exec.context->_readAheadDirection);
+
                     //! \bug Workaround for files that are missing timecode.
                     if (clip->available_range().start_time() !=
                         read->getTimeRange().start_time())
@@ -374,63 +667,118 @@ namespace toucan
                         t -= clip->available_range().start_time();
                     }
 
-                    read->setTime(t);
+                    out = std::make_shared<ReadFrameNode>(read, t);
                 }
-                out = read;
             }
             else if (auto sequenceRef = dynamic_cast<OTIO_NS::ImageSequenceReference*>(mediaRef))
             {
-                std::shared_ptr<IReadNode> read;
-                if (!_readCache.get(sequenceRef, read))
+                if (auto read = _getReadNode(exec, sequenceRef))
+                {
+                    read->setReadAhead(
+                        exec.context->_readAhead,
+                        exec.context->_readAheadDirection);
+                    out = std::make_shared<ReadFrameNode>(read, t);
+                }
+            }
+            else if (auto generatorRef = dynamic_cast<OTIO_NS::GeneratorReference*>(mediaRef))
+            {
+                const auto& parameters = generatorRef->parameters();
+                if ("toucan:Fill" == generatorRef->generator_kind())
                 {
-                    try
+                    // Fill generators are constant images, with the same
+                    // defaults as the plugin.
+                    IMATH_NAMESPACE::V2i size(1280, 720);
+                    IMATH_NAMESPACE::V4f color(0.F, 0.F, 0.F, 0.F);
+                    auto i = parameters.find("size");
+                    if (i != parameters.end() && i->second.has_value())
                     {
-                        read = _timelineWrapper->createReadNode(sequenceRef);
-                        _readCache.add(sequenceRef, read);
+                        anyToVec(std::any_cast<OTIO_NS::AnyVector>(i->second), size);
                     }
-                    catch (const std::exception& e)
+                    i = parameters.find("color");
+                    if (i != parameters.end() && i->second.has_value())
                     {
-                        _context.lock()->getSystem<ftk::LogSystem>()->print(
-                            logPrefix,
-                            e.what(),
-                            ftk::LogType::Error);
+                        anyToVec(std::any_cast<OTIO_NS::AnyVector>(i->second), color);
                     }
+                    out = _createConstant(exec, size, color);
                 }
-                if (read)
+                else
                 {
-                    read->setTime(t);
+                    out = _createNode(
+                        exec,
+                        parameters,
+                        generatorRef->generator_kind());
                 }
-                out = read;
-            }
-            else if (auto generatorRef = dynamic_cast<OTIO_NS::GeneratorReference*>(mediaRef))
-            {
-                out = _host->createNode(
-                    generatorRef->parameters(),
-                    generatorRef->generator_kind());
             }
         }
         else if (auto gap = OTIO_NS::dynamic_retainer_cast<OTIO_NS::Gap>(item))
         {
-            OTIO_NS::AnyDictionary metaData;
-            metaData["size"] = vecToAny(_imageSize);
-            out = _host->createNode(metaData, "toucan:Fill");
+            out = _createConstant(
+                exec,
+                _imageSize,
+                IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 0.F));
         }
 
         // Add the effects.
-        out = _effects(t, effects, out);
+        out = _effects(exec, t, effects, out);
 
-        if (item == _itemNode)
+        if (item == exec.itemNode)
         {
-            _outNode = out;
+            exec.outNode = out;
         }
 
         return out;
     }
 
+    std::shared_ptr<IReadNode> ImageGraph::_getReadNode(
+        Exec& exec,
+        const OTIO_NS::MediaReference* mediaRef)
+    {
+        std::shared_ptr<IReadNode> out;
+        ImageGraphContext& context = *exec.context;
+        const auto i = context._reads.find(mediaRef);
+        if (i != context._reads.end())
+        {
+            out = i->second.read;
+        }
+        else
+        {
+            if (!context._mediaPool)
+            {
+                context._mediaPool = _mediaPool;
+            }
+            const std::string key = _timelineWrapper->getMediaKey(mediaRef);
+            try
+            {
+                out = context._mediaPool->checkOut(
+                    key,
+                    [this, mediaRef]
+                    {
+                        return _timelineWrapper->createReadNode(mediaRef);
+                    });
+            }
+            catch (const std::exception& e)
+            {
+                _context.lock()->getSystem<ftk::LogSystem>()->print(
+                    logPrefix,
+                    e.what(),
+                    ftk::LogType::Error);
+            }
+            if (out)
+            {
+                context._reads[mediaRef] = { key, out };
+            }
+        }
+        if (out)
+        {
+            exec.reads.insert(mediaRef);
+        }
+        return out;
+    }
+
     OTIO_NS::RationalTime ImageGraph::_timeWarps(
         const OTIO_NS::RationalTime& time,
         const OTIO_NS::TimeRange& timeRange,
-        const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >& effects)
+        const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >& effects) const
     {
         OTIO_NS::RationalTime out = time;
         for (const auto& effect : effects)
@@ -447,14 +795,16 @@ namespace toucan
     }
 
     std::shared_ptr<IImageNode> ImageGraph::_effects(
+        Exec& exec,
         const OTIO_NS::RationalTime& time,
         const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >& effects,
-        const std::shared_ptr<IImageNode>& input)
+        const std::shared_ptr<IImageNode>& input) const
     {
         std::shared_ptr<IImageNode> out = input;
         for (const auto& effect : effects)
         {
-            if (auto imageEffect = _host->createNode(
+            if (auto imageEffect = _createNode(
+                exec,
                 effect->metadata(),
                 effect->effect_name(),
                 { out }))
@@ -3,20 +3,71 @@
 
 #pragma once
 
+#include <toucanRender/ImageCache.h>
 #include <toucanRender/ImageNode.h>
+#include <toucanRender/MediaPool.h>
 #include <toucanRender/TimelineWrapper.h>
 
 #include <ftk/Core/Context.h>
-#include <ftk/Core/LRUCache.h>
 
 #include <opentimelineio/track.h>
 #include <opentimelineio/transition.h>
 
 #include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 
 namespace toucan
 {
+    class IReadNode;
+
+    //! Image graph evaluation context. The context holds the state that is
+    //! kept between calls to ImageGraph::exec(), so a single image graph can
+    //! be executed concurrently by using a separate context for each thread.
+    class ImageGraphContext
+    {
+    public:
+        ImageGraphContext();
+
+        ~ImageGraphContext();
+
+        ImageGraphContext(const ImageGraphContext&) = delete;
+        ImageGraphContext& operator = (const ImageGraphContext&) = delete;
+
+        //! Set the number of frames that read nodes decode ahead in the
+        //! background. This is useful when the graph is executed for
+        //! sequential times, for example during playback. The direction
+        //! is 1 for forward playback and -1 for reverse playback.
+        void setReadAhead(size_t, int direction = 1);
+
+    private:
+        friend class ImageGraph;
+
+        size_t _readAhead = 0;
+        int _readAheadDirection = 1;
+        std::vector<size_t> _hints;
+
+        // The nodes are re-used between frames in the same edit segment,
+        // where the active items and transitions do not change. Nodes are
+        // matched in the order they are created.
+        std::vector<int> _segment;
+        std::vector<std::shared_ptr<IImageNode> > _segmentNodes;
+
+        // The read nodes checked out from the media pool. Each context has
+        // its own read nodes, they are kept while the media is used and
+        // checked back in when it is no longer used.
+        struct Read
+        {
+            std::string key;
+            std::shared_ptr<IReadNode> read;
+        };
+        std::shared_ptr<MediaPool> _mediaPool;
+        std::map<const OTIO_NS::MediaReference*, Read> _reads;
+    };
+
     //! Create image graphs from a timeline.
     class ImageGraph : public std::enable_shared_from_this<ImageGraph>
     {
@@ -37,30 +88,141 @@ namespace toucan
         //! Get the timeline image data type.
         const std::string& getImageDataType() const;
 
-        //! Get an image graph for the given time.
+        //! Get the timeline image specification.
+        OIIO::ImageSpec getImageSpec() const;
+
+        //! Get the image cache.
+        std::shared_ptr<ImageCache> getImageCache() const;
+
+        //! Set the image cache. The cache can be shared between image
+        //! graphs, for example when rendering frames on multiple threads.
+        void setImageCache(const std::shared_ptr<ImageCache>&);
+
+        //! Set the number of frames to read ahead for the default context.
+        void setReadAhead(size_t, int direction = 1);
+
+        //! Get an image graph for the given time, using the default
+        //! context. Calls that use the default context must not be made
+        //! concurrently.
         std::shared_ptr<IImageNode> exec(
             const std::shared_ptr<ImageEffectHost>&,
             const OTIO_NS::RationalTime&,
             const OTIO_NS::Item* = nullptr);
 
+        //! Get an image graph for the given time. This can be called from
+        //! multiple threads as long as each uses its own context. The
+        //! returned nodes are not shared between contexts.
+        std::shared_ptr<IImageNode> exec(
+            ImageGraphContext&,
+            const std::shared_ptr<ImageEffectHost>&,
+            const OTIO_NS::RationalTime&,
+            const OTIO_NS::Item* = nullptr);
+
     private:
+        // The timeline is flattened into sorted arrays of item ranges when
+        // the graph is created, so that finding the items for a given time
+        // does not require walking the tracks.
+        struct TransitionEntry
+        {
+            OTIO_NS::TimeRange range;
+            OTIO_NS::SerializableObject::Retainer<OTIO_NS::Transition> transition;
+        };
+        struct ItemEntry
+        {
+            OTIO_NS::TimeRange range;
+            OTIO_NS::RationalTime rangeStart;
+            OTIO_NS::RationalTime trimmedStart;
+            OTIO_NS::SerializableObject::Retainer<OTIO_NS::Item> item;
+            int prevTransition = -1;
+            int prevItem = -1;
+            int nextTransition = -1;
+            int nextItem = -1;
+        };
+        struct TrackEntry
+        {
+            OTIO_NS::SerializableObject::Retainer<OTIO_NS::Track> track;
+            OTIO_NS::TimeRange availableRange;
+            std::vector<ItemEntry> items;
+            std::vector<TransitionEntry> transitions;
+        };
+
+        // The state for a single call to exec().
+        struct Exec
+        {
+            ImageGraphContext* context = nullptr;
+            std::shared_ptr<ImageEffectHost> host;
+            const OTIO_NS::Item* itemNode = nullptr;
+            std::shared_ptr<IImageNode> outNode;
+            size_t segmentIndex = 0;
+            std::vector<std::shared_ptr<IImageNode> > segmentNodes;
+            std::set<const OTIO_NS::MediaReference*> reads;
+        };
+
+        void _index();
+
+        OTIO_NS::RationalTime _trackTime(
+            const OTIO_NS::RationalTime&,
+            const TrackEntry&) const;
+
+        std::vector<int> _getSegment(
+            Exec&,
+            const OTIO_NS::RationalTime&) const;
+
+        std::shared_ptr<IImageNode> _reuseNode(
+            Exec&,
+            const std::string& name,
+            const std::vector<std::shared_ptr<IImageNode> >&) const;
+
+        std::shared_ptr<IImageNode> _createNode(
+            Exec&,
+            const OTIO_NS::AnyDictionary&,
+            const std::string& name,
+            const std::vector<std::shared_ptr<IImageNode> >& = {}) const;
+
+        std::shared_ptr<IImageNode> _createConstant(
+            Exec&,
+            const IMATH_NAMESPACE::V2i& size,
+            const IMATH_NAMESPACE::V4f& color) const;
+
+        std::shared_ptr<IImageNode> _createComp(
+            Exec&,
+            const std::vector<std::shared_ptr<IImageNode> >&) const;
+
+        const ItemEntry* _findItem(
+            const TrackEntry&,
+            size_t& hint,
+            const OTIO_NS::RationalTime&) const;
+
         std::shared_ptr<IImageNode> _track(
+            Exec&,
             const OTIO_NS::RationalTime&,
-            const OTIO_NS::SerializableObject::Retainer<OTIO_NS::Track>&);
+            size_t index);
+
+        std::shared_ptr<IImageNode> _transition(
+            Exec&,
+            const OTIO_NS::RationalTime&,
+            const TransitionEntry&,
+            const std::vector<std::shared_ptr<IImageNode> >&) const;
 
         std::shared_ptr<IImageNode> _item(
+            Exec&,
             const OTIO_NS::RationalTime&,
             const OTIO_NS::SerializableObject::Retainer<OTIO_NS::Item>&);
 
+        std::shared_ptr<IReadNode> _getReadNode(
+            Exec&,
+            const OTIO_NS::MediaReference*);
+
         OTIO_NS::RationalTime _timeWarps(
             const OTIO_NS::RationalTime&,
             const OTIO_NS::TimeRange&,
-            const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >&);
+            const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >&) const;
 
         std::shared_ptr<IImageNode> _effects(
+            Exec&,
             const OTIO_NS::RationalTime&,
             const std::vector<OTIO_NS::SerializableObject::Retainer<OTIO_NS::Effect> >&,
-            const std::shared_ptr<IImageNode>&);
+            const std::shared_ptr<IImageNode>&) const;
 
         std::weak_ptr<ftk::Context> _context;
         std::filesystem::path _path;
@@ -69,11 +231,17 @@ namespace toucan
         IMATH_NAMESPACE::V2i _imageSize = IMATH_NAMESPACE::V2i(0, 0);
         int _imageChannels = 0;
         std::string _imageDataType;
-        ftk::LRUCache<const OTIO_NS::MediaReference*, std::shared_ptr<IReadNode> > _readCache;
-
-        // Temporary variables available during execution.
-        std::shared_ptr<ImageEffectHost> _host;
-        const OTIO_NS::Item* _itemNode = nullptr;
-        std::shared_ptr<IImageNode> _outNode;
+        OIIO::TypeDesc _imageFormat;
+        OTIO_NS::TimeRange _stackAvailableRange;
+        std::vector<TrackEntry> _tracks;
+        std::shared_ptr<MediaPool> _mediaPool;
+        ImageGraphContext _defaultContext;
+
+        struct Mutex
+        {
+            std::shared_ptr<ImageCache> imageCache;
+            std::mutex mutex;
+        };
+        mutable Mutex _mutex;
     };
 }
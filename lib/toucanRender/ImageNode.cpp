@@ -3,8 +3,44 @@
 
 #include "ImageNode.h"
 
+#include "ImageArena.h"
+#include "ImageCache.h"
+#include "Util.h"
+
+#include <OpenImageIO/thread.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <set>
+#include <sstream>
+
 namespace toucan
 {
+    namespace
+    {
+        OIIO::ROI roiUnion(const OIIO::ROI& a, const OIIO::ROI& b)
+        {
+            return a.defined() && b.defined() ?
+                OIIO::roi_union(a, b) :
+                OIIO::ROI::All();
+        }
+
+        // Get whether an image uses the pixel memory of another image.
+        bool isAliased(const OIIO::ImageBuf& buf, const OIIO::ImageBuf& other)
+        {
+            const uintptr_t data = reinterpret_cast<uintptr_t>(buf.localpixels());
+            const uintptr_t otherData = reinterpret_cast<uintptr_t>(other.localpixels());
+            return
+                data &&
+                otherData &&
+                data >= otherData &&
+                data < otherData + other.spec().image_bytes();
+        }
+    }
+
     IImageNode::IImageNode(
         const std::string& name,
         const std::vector<std::shared_ptr<IImageNode> >& inputs) :
@@ -40,6 +76,77 @@ namespace toucan
         _time = value;
     }
 
+    std::size_t IImageNode::getHash() const
+    {
+        std::size_t out = std::hash<std::string>()(_name);
+        for (size_t i = 0; i < _inputs.size(); ++i)
+        {
+            hashCombine(out, _inputs[i] && _isInputNeeded(i) ? _inputs[i]->getHash() : 0);
+        }
+        return out;
+    }
+
+    OIIO::ROI IImageNode::getRegionOfDefinition() const
+    {
+        OIIO::ROI out;
+        for (const auto& input : _inputs)
+        {
+            if (input)
+            {
+                out = input->getRegionOfDefinition();
+                break;
+            }
+        }
+        return out;
+    }
+
+    bool IImageNode::isOpaque() const
+    {
+        return false;
+    }
+
+    OIIO::TypeDesc IImageNode::getFormat() const
+    {
+        OIIO::TypeDesc out = OIIO::TypeDesc::UNKNOWN;
+        for (const auto& input : _inputs)
+        {
+            if (input)
+            {
+                out = input->getFormat();
+                break;
+            }
+        }
+        return out;
+    }
+
+    void IImageNode::setImageCache(const std::shared_ptr<ImageCache>& value)
+    {
+        _imageCache = value;
+    }
+
+    OIIO::ImageBuf IImageNode::exec(const OIIO::ROI& roi)
+    {
+        OIIO::ImageBuf out;
+        EvalScope scope(this);
+
+        // Use the cached image without executing the inputs.
+        _roi = roi;
+        if (_imageCache && _imageCache->get(_getCacheHash(), out))
+        {
+            return out;
+        }
+
+        ImageArena arena;
+        const std::vector<IImageNode*> nodes = _evalInit(roi, &arena);
+        _evalRun(nodes);
+        return _evalFinish(nodes, arena, _eval());
+    }
+
+    double IImageNode::getExecTime() const
+    {
+        return _evalTime;
+    }
+
     std::vector<std::string> IImageNode::graph(const std::string& name)
     {
         std::vector<std::string> out;
@@ -72,6 +179,440 @@ namespace toucan
         }
     }
 
+    OIIO::ImageBuf IImageNode::_execInput(size_t index)
+    {
+        OIIO::ImageBuf out;
+        if (index < _inputs.size() && _inputs[index] && _isInputNeeded(index))
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            out = _inputs[index]->_eval();
+            const std::chrono::duration<double> diff =
+                std::chrono::steady_clock::now() - t0;
+            _evalInputTime += diff.count();
+
+            // Keep track of the images from the arena, so their memory
+            // can be released when this node is finished with them.
+            if (_evalArena && _evalArena->owns(out))
+            {
+                std::unique_lock<std::mutex> lock(_evalMutex);
+                _evalInputs.push_back(out);
+            }
+        }
+        return out;
+    }
+
+    OIIO::ImageBuf IImageNode::_allocateImage(
+        const OIIO::ImageSpec& spec,
+        OIIO::InitializePixels initialize) const
+    {
+        return _arena && _evalBuffer >= 0 ?
+            _arena->allocate(static_cast<size_t>(_evalBuffer), spec, initialize) :
+            allocateImage(_arena, spec, initialize);
+    }
+
+    bool IImageNode::_isImageOwned(const OIIO::ImageBuf& buf) const
+    {
+        return
+            OIIO::ImageBuf::LOCALBUFFER == buf.storage() ||
+            (_arena && _arena->owns(buf));
+    }
+
+    OIIO::ROI IImageNode::_getInputROI(size_t, const OIIO::ROI& roi) const
+    {
+        return roi;
+    }
+
+    bool IImageNode::_isInputNeeded(size_t) const
+    {
+        return true;
+    }
+
+    void IImageNode::_evalBegin()
+    {}
+
+    void IImageNode::_evalEnd()
+    {}
+
+    IImageNode::EvalScope::EvalScope(IImageNode* root)
+    {
+        // All of the nodes in the graph are included, since the inputs
+        // that are not needed may still be queried by their consumers.
+        std::set<IImageNode*> visited;
+        std::vector<IImageNode*> stack = { root };
+        while (!stack.empty())
+        {
+            IImageNode* node = stack.back();
+            stack.pop_back();
+            if (visited.insert(node).second)
+            {
+                _nodes.push_back(node);
+                for (const auto& input : node->_inputs)
+                {
+                    if (input)
+                    {
+                        stack.push_back(input.get());
+                    }
+                }
+            }
+        }
+        for (size_t i = 0; i < _nodes.size(); ++i)
+        {
+            try
+            {
+                _nodes[i]->_evalBegin();
+            }
+            catch (...)
+            {
+                for (size_t j = 0; j < i; ++j)
+                {
+                    _nodes[j]->_evalEnd();
+                }
+                throw;
+            }
+        }
+    }
+
+    IImageNode::EvalScope::~EvalScope()
+    {
+        for (const auto node : _nodes)
+        {
+            node->_evalEnd();
+        }
+    }
+
+    std::vector<IImageNode*> IImageNode::_evalInit(const OIIO::ROI& roi, ImageArena* arena)
+    {
+        // Find the unique nodes in the graph.
+        std::vector<IImageNode*> nodes;
+        std::set<IImageNode*> visited;
+        std::vector<IImageNode*> stack = { this };
+        while (!stack.empty())
+        {
+            IImageNode* node = stack.back();
+            stack.pop_back();
+            if (visited.insert(node).second)
+            {
+                nodes.push_back(node);
+                for (size_t i = 0; i < node->_inputs.size(); ++i)
+                {
+                    if (node->_inputs[i] && node->_isInputNeeded(i))
+                    {
+                        stack.push_back(node->_inputs[i].get());
+                    }
+                }
+            }
+        }
+
+        // Count the number of consumers of each node.
+        for (const auto node : nodes)
+        {
+            node->_evalConsumers = 0;
+            node->_evalValid = false;
+            node->_evalBuf.reset();
+            node->_evalTime = 0.0;
+            node->_evalInputTime = 0.0;
+            node->_evalArena = arena;
+            node->_evalInputs.clear();
+            node->_evalBuffer = -1;
+            node->_arena = arena;
+        }
+        _arena = nullptr;
+        for (const auto node : nodes)
+        {
+            for (size_t i = 0; i < node->_inputs.size(); ++i)
+            {
+                if (node->_inputs[i] && node->_isInputNeeded(i))
+                {
+                    ++node->_inputs[i]->_evalConsumers;
+                }
+            }
+        }
+        _evalConsumers = 1;
+
+        // Propagate the region of interest from the consumers to the
+        // inputs. A node is visited after all of its consumers, so its
+        // region of interest covers the regions needed by each of them.
+        std::map<IImageNode*, size_t> consumers;
+        for (const auto node : nodes)
+        {
+            consumers[node] = node->_evalConsumers;
+        }
+        std::set<IImageNode*> requested;
+        _roi = roi;
+        std::vector<IImageNode*> ready = { this };
+        while (!ready.empty())
+        {
+            IImageNode* node = ready.back();
+            ready.pop_back();
+            for (size_t i = 0; i < node->_inputs.size(); ++i)
+            {
+                auto input = node->_inputs[i].get();
+                if (input && node->_isInputNeeded(i))
+                {
+                    const OIIO::ROI inputROI = node->_getInputROI(i, node->_roi);
+                    input->_roi = requested.insert(input).second ?
+                        inputROI :
+                        roiUnion(input->_roi, inputROI);
+                    if (0 == --consumers[input])
+                    {
+                        ready.push_back(input);
+                    }
+                }
+            }
+        }
+
+        return nodes;
+    }
+
+    void IImageNode::_evalRun(const std::vector<IImageNode*>& nodes)
+    {
+        // Count the inputs that each node is waiting for, and find the
+        // consumers of each node.
+        std::map<IImageNode*, size_t> waiting;
+        std::map<IImageNode*, std::vector<IImageNode*> > consumers;
+        std::vector<IImageNode*> ready;
+        bool branches = false;
+        for (const auto node : nodes)
+        {
+            std::set<IImageNode*> inputs;
+            for (size_t i = 0; i < node->_inputs.size(); ++i)
+            {
+                if (node->_inputs[i] && node->_isInputNeeded(i))
+                {
+                    inputs.insert(node->_inputs[i].get());
+                }
+            }
+            waiting[node] = inputs.size();
+            for (const auto input : inputs)
+            {
+                consumers[input].push_back(node);
+            }
+            if (inputs.empty())
+            {
+                ready.push_back(node);
+            }
+            branches |= inputs.size() > 1;
+        }
+
+        // Execute the nodes serially if the graph does not have branches,
+        // or if this is already running on a pool thread.
+        OIIO::thread_pool* pool = OIIO::default_thread_pool();
+        if (!branches || pool->size() < 1 || pool->this_thread_is_in_pool())
+        {
+            while (!ready.empty())
+            {
+                IImageNode* node = ready.back();
+                ready.pop_back();
+                node->_evalCompute();
+                for (const auto consumer : consumers[node])
+                {
+                    if (0 == --waiting[consumer])
+                    {
+                        ready.push_back(consumer);
+                    }
+                }
+            }
+            return;
+        }
+
+        // Execute the nodes on the thread pool as soon as their inputs are
+        // ready. This thread also executes nodes instead of waiting, so the
+        // image operations of those nodes can use the whole pool.
+        struct State
+        {
+            std::vector<IImageNode*> ready;
+            size_t running = 0;
+            size_t remaining = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        State state;
+        state.ready = ready;
+        state.remaining = nodes.size();
+        const auto run = [&state, &waiting, &consumers](IImageNode* node)
+        {
+            std::exception_ptr error;
+            try
+            {
+                node->_evalCompute();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            std::unique_lock<std::mutex> lock(state.mutex);
+            if (error && !state.error)
+            {
+                state.error = error;
+            }
+            --state.running;
+            --state.remaining;
+            for (const auto consumer : consumers[node])
+            {
+                if (0 == --waiting[consumer])
+                {
+                    state.ready.push_back(consumer);
+                }
+            }
+            state.cv.notify_all();
+        };
+        std::unique_lock<std::mutex> lock(state.mutex);
+        while (state.remaining > 0 && !state.error)
+        {
+            if (state.ready.empty())
+            {
+                state.cv.wait(lock);
+                continue;
+            }
+            const std::vector<IImageNode*> submit(state.ready.begin(), state.ready.end() - 1);
+            IImageNode* node = state.ready.back();
+            state.running += state.ready.size();
+            state.ready.clear();
+            lock.unlock();
+            for (const auto i : submit)
+            {
+                pool->push([&run, i](int) { run(i); });
+            }
+            run(node);
+            lock.lock();
+        }
+        state.cv.wait(lock, [&state] { return 0 == state.running; });
+        if (state.error)
+        {
+            std::rethrow_exception(state.error);
+        }
+    }
+
+    OIIO::ImageBuf IImageNode::_evalFinish(
+        const std::vector<IImageNode*>& nodes,
+        ImageArena& arena,
+        OIIO::ImageBuf out)
+    {
+        // The image is returned to the caller, so it is copied if the
+        // pixel memory belongs to the arena.
+        if (arena.owns(out))
+        {
+            OIIO::ImageBuf tmp;
+            tmp.copy(out);
+            out = std::move(tmp);
+        }
+
+        // Release the images that were not used by a consumer.
+        for (const auto node : nodes)
+        {
+            node->_evalBuf.reset();
+            node->_evalValid = false;
+            node->_evalArena = nullptr;
+            node->_evalInputs.clear();
+            node->_evalBuffer = -1;
+            node->_arena = nullptr;
+        }
+        return out;
+    }
+
+    void IImageNode::_evalCompute()
+    {
+        OIIO::ImageBuf out;
+        const auto t0 = std::chrono::steady_clock::now();
+        if (_imageCache)
+        {
+            const std::size_t hash = _getCacheHash();
+            if (!_imageCache->get(hash, out))
+            {
+                out = _exec();
+                if (_arena && _arena->owns(out))
+                {
+                    OIIO::ImageBuf tmp;
+                    tmp.copy(out);
+                    _imageCache->add(hash, tmp);
+                }
+                else
+                {
+                    _imageCache->add(hash, out);
+                }
+            }
+        }
+        else
+        {
+            out = _exec();
+        }
+
+        // Return the memory of the input images to the pool, unless it is
+        // used by the output image.
+        std::vector<OIIO::ImageBuf> inputs;
+        {
+            std::unique_lock<std::mutex> lock(_evalMutex);
+            inputs.swap(_evalInputs);
+        }
+        for (const auto& input : inputs)
+        {
+            if (!isAliased(out, input))
+            {
+                _evalArena->release(input);
+            }
+        }
+        const std::chrono::duration<double> diff =
+            std::chrono::steady_clock::now() - t0;
+
+        std::unique_lock<std::mutex> lock(_evalMutex);
+        _evalTime = diff.count() - _evalInputTime;
+        _evalBuf = std::move(out);
+        _evalValid = true;
+    }
+
+    OIIO::ImageBuf IImageNode::_eval()
+    {
+        OIIO::ImageBuf out;
+        std::unique_lock<std::mutex> lock(_evalMutex);
+        if (!_evalValid)
+        {
+            lock.unlock();
+            _evalCompute();
+            lock.lock();
+        }
+
+        // The image is shared between the consumers, the last consumer
+        // takes ownership of the image. Each consumer gets its own pixels,
+        // since copies of arena images share the pixel memory.
+        if (_evalConsumers > 1)
+        {
+            if (_arena && _arena->owns(_evalBuf))
+            {
+                out = _arena->allocate(_evalBuf.spec(), OIIO::InitializePixels::No);
+                out.copy_pixels(_evalBuf);
+            }
+            else
+            {
+                out = _evalBuf;
+            }
+        }
+        else
+        {
+            out = std::move(_evalBuf);
+            _evalBuf.reset();
+            _evalValid = false;
+        }
+        if (_evalConsumers > 0)
+        {
+            --_evalConsumers;
+        }
+        return out;
+    }
+
+    std::size_t IImageNode::_getCacheHash() const
+    {
+        std::size_t out = getHash();
+        if (_roi.defined())
+        {
+            hashCombine(out, _roi.xbegin);
+            hashCombine(out, _roi.xend);
+            hashCombine(out, _roi.ybegin);
+            hashCombine(out, _roi.yend);
+        }
+        return out;
+    }
+
     std::string IImageNode::_getGraphName() const
     {
         std::stringstream ss;
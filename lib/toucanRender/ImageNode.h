@@ -8,10 +8,13 @@
 #include <OpenImageIO/imagebuf.h>
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace toucan
 {
+    class ImageArena;
+    class ImageCache;
     class ImageEffectHost;
 
     //! Base class for image nodes.
@@ -39,13 +42,101 @@ namespace toucan
         //! Set the time.
         void setTime(const OTIO_NS::RationalTime&);
 
+        //! Get a hash of the node and its inputs. Nodes with the same hash
+        //! produce the same image.
+        virtual std::size_t getHash() const;
+
+        //! Get the region of definition. This is the area of the image that
+        //! the node produces. An undefined ROI means the area is not known
+        //! until the node is executed.
+        virtual OIIO::ROI getRegionOfDefinition() const;
+
+        //! Get whether the image is opaque, with an alpha of one over the
+        //! whole region of definition. This is used to skip the inputs
+        //! that are hidden by an opaque image. The default is false, which
+        //! is always safe.
+        virtual bool isOpaque() const;
+
+        //! Get the pixel format of the image, or UNKNOWN if it is not known
+        //! until the node is executed. This is used to estimate the memory
+        //! needed to execute the graph. The default is the format of the
+        //! first input.
+        virtual OIIO::TypeDesc getFormat() const;
+
+        //! Set the image cache. If the image for this node's hash is in the
+        //! cache it is used instead of executing the node.
+        void setImageCache(const std::shared_ptr<ImageCache>&);
+
         //! Execute the image operation.
-        virtual OIIO::ImageBuf exec() = 0;
+        //!
+        //! Nodes that are inputs to more than one node in the graph are
+        //! only executed once per call, and their image is shared between
+        //! the consumers.
+        //!
+        //! Nodes are executed as soon as their inputs are ready, so that
+        //! independent branches of the graph, like the tracks of a
+        //! composite, are executed concurrently on the OpenImageIO thread
+        //! pool. A node that runs on a pool thread executes its own
+        //! image operations serially, so the pool is not oversubscribed.
+        //!
+        //! The region of interest limits the area of the image that is
+        //! computed, it is propagated through the graph so that each node
+        //! only processes the pixels needed. The returned image has the
+        //! full size, pixels outside of the region of interest are
+        //! undefined.
+        OIIO::ImageBuf exec(const OIIO::ROI& = OIIO::ROI::All());
+
+        //! Get the time in seconds spent executing this node during the
+        //! last call to exec(), not including the time spent executing
+        //! the inputs.
+        double getExecTime() const;
 
         //! Generate a Grapviz graph
         std::vector<std::string> graph(const std::string& name);
 
     protected:
+        virtual OIIO::ImageBuf _exec() = 0;
+
+        //! Execute an input. Node implementations should use this instead
+        //! of calling exec() on the inputs directly. The pixel memory of
+        //! the image is released after _exec() returns, unless it is used
+        //! by the returned image, so the image must not be kept.
+        OIIO::ImageBuf _execInput(size_t);
+
+        //! Allocate an image. Images are allocated from the arena of the
+        //! current evaluation, so their pixel memory is re-used between
+        //! frames. When the node is executed by an image plan, the image
+        //! is allocated from the buffer of the node's step if it is free.
+        //! Node implementations should use this instead of allocating
+        //! images directly.
+        OIIO::ImageBuf _allocateImage(
+            const OIIO::ImageSpec&,
+            OIIO::InitializePixels = OIIO::InitializePixels::Yes) const;
+
+        //! Get whether an image returned by _execInput() is only used by
+        //! this node, so it can be modified in place. Images with their
+        //! own pixel memory, or with pixel memory from the arena of the
+        //! current evaluation, are not shared with other consumers.
+        bool _isImageOwned(const OIIO::ImageBuf&) const;
+
+        //! Get the region of an input needed to compute the given region
+        //! of this node. The default is the same region, which is correct
+        //! for point-wise operations.
+        virtual OIIO::ROI _getInputROI(size_t, const OIIO::ROI&) const;
+
+        //! Get whether an input is needed to compute this node. Inputs
+        //! that are not needed are not executed, and _execInput() returns
+        //! an empty image for them. The default is true.
+        virtual bool _isInputNeeded(size_t) const;
+
+        //! Called for each node of the graph before it is evaluated. Nodes
+        //! can override this to compute values that do not change during
+        //! the evaluation once, instead of every time they are needed.
+        virtual void _evalBegin();
+
+        //! Called for each node of the graph after it is evaluated.
+        virtual void _evalEnd();
+
         void _graph(
             const std::shared_ptr<IImageNode>&,
             std::vector<std::string>&);
@@ -54,5 +145,50 @@ namespace toucan
         std::string _name;
         std::vector<std::shared_ptr<IImageNode> > _inputs;
         OTIO_NS::RationalTime _time;
+        std::shared_ptr<ImageCache> _imageCache;
+
+        //! The region of interest for the current evaluation.
+        OIIO::ROI _roi;
+
+        //! The image arena for the current evaluation. This is null for
+        //! the node that is executed, since its image is returned to the
+        //! caller.
+        ImageArena* _arena = nullptr;
+
+    private:
+        friend class ImagePlan;
+
+        //! Begin the evaluation of the nodes of a graph, and end it when
+        //! the scope is destroyed.
+        class EvalScope
+        {
+        public:
+            EvalScope(IImageNode*);
+
+            ~EvalScope();
+
+        private:
+            std::vector<IImageNode*> _nodes;
+        };
+
+        std::vector<IImageNode*> _evalInit(const OIIO::ROI&, ImageArena*);
+        void _evalRun(const std::vector<IImageNode*>&);
+        OIIO::ImageBuf _evalFinish(
+            const std::vector<IImageNode*>&,
+            ImageArena&,
+            OIIO::ImageBuf);
+        void _evalCompute();
+        OIIO::ImageBuf _eval();
+        std::size_t _getCacheHash() const;
+
+        std::mutex _evalMutex;
+        ImageArena* _evalArena = nullptr;
+        std::vector<OIIO::ImageBuf> _evalInputs;
+        int _evalBuffer = -1;
+        size_t _evalConsumers = 0;
+        bool _evalValid = false;
+        OIIO::ImageBuf _evalBuf;
+        double _evalTime = 0.0;
+        double _evalInputTime = 0.0;
     };
 }
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImagePlan.h"
+
+#include "ImageArena.h"
+#include "ImageCache.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace toucan
+{
+    namespace
+    {
+        size_t getBytes(IImageNode* node, const OIIO::ImageSpec& spec)
+        {
+            // The size comes from the region of definition and the format
+            // from the node, the image specification is used for the
+            // values that are not known. Images are converted to RGBA when
+            // they are read, so four channels are an upper bound.
+            size_t width = spec.width > 0 ? spec.width : 0;
+            size_t height = spec.height > 0 ? spec.height : 0;
+            const OIIO::ROI rod = node->getRegionOfDefinition();
+            if (rod.defined())
+            {
+                width = rod.width();
+                height = rod.height();
+            }
+            OIIO::TypeDesc format = node->getFormat();
+            if (OIIO::TypeDesc::UNKNOWN == format)
+            {
+                format = spec.format != OIIO::TypeDesc::UNKNOWN ?
+                    spec.format :
+                    OIIO::TypeDesc(OIIO::TypeDesc::FLOAT);
+            }
+            return width * height * 4 * format.size();
+        }
+    }
+
+    ImagePlan::ImagePlan(
+        const std::shared_ptr<IImageNode>& root,
+        const OIIO::ImageSpec& spec) :
+        _spec(spec)
+    {
+        _build(root);
+    }
+
+    ImagePlan::~ImagePlan()
+    {}
+
+    const std::vector<ImagePlanStep>& ImagePlan::getSteps() const
+    {
+        return _steps;
+    }
+
+    size_t ImagePlan::getBufferCount() const
+    {
+        return _bufferCount;
+    }
+
+    size_t ImagePlan::getPeakMemory() const
+    {
+        return _peakMemory;
+    }
+
+    void ImagePlan::_build(const std::shared_ptr<IImageNode>& root)
+    {
+        _steps.clear();
+        _bufferSizes.clear();
+        _bufferCount = 0;
+        _peakMemory = 0;
+        if (!root)
+        {
+            return;
+        }
+
+        // Find the unique nodes and their unique inputs, skipping the
+        // inputs that are not needed.
+        std::vector<IImageNode*> nodes;
+        std::map<IImageNode*, std::shared_ptr<IImageNode> > sharedNodes;
+        std::map<IImageNode*, std::vector<IImageNode*> > inputs;
+        std::map<IImageNode*, std::vector<IImageNode*> > consumers;
+        std::vector<IImageNode*> stack = { root.get() };
+        sharedNodes[root.get()] = root;
+        while (!stack.empty())
+        {
+            IImageNode* node = stack.back();
+            stack.pop_back();
+            if (inputs.find(node) != inputs.end())
+            {
+                continue;
+            }
+            nodes.push_back(node);
+            std::vector<IImageNode*>& nodeInputs = inputs[node];
+            const auto& nodeSharedInputs = node->getInputs();
+            for (size_t i = 0; i < nodeSharedInputs.size(); ++i)
+            {
+                const auto& input = nodeSharedInputs[i];
+                if (input &&
+                    node->_isInputNeeded(i) &&
+                    std::find(nodeInputs.begin(), nodeInputs.end(), input.get()) == nodeInputs.end())
+                {
+                    nodeInputs.push_back(input.get());
+                    consumers[input.get()].push_back(node);
+                    sharedNodes[input.get()] = input;
+                    stack.push_back(input.get());
+                }
+            }
+        }
+
+        // Estimate the memory needed to execute each node, starting with
+        // the nodes that do not have inputs. The inputs of each node are
+        // sorted so that the input needing the most memory comes first.
+        std::map<IImageNode*, size_t> bytes;
+        std::map<IImageNode*, size_t> need;
+        std::map<IImageNode*, size_t> waiting;
+        std::vector<IImageNode*> ready;
+        for (const auto node : nodes)
+        {
+            bytes[node] = getBytes(node, _spec);
+            waiting[node] = inputs[node].size();
+            if (inputs[node].empty())
+            {
+                ready.push_back(node);
+            }
+        }
+        while (!ready.empty())
+        {
+            IImageNode* node = ready.back();
+            ready.pop_back();
+            std::vector<IImageNode*>& nodeInputs = inputs[node];
+            std::stable_sort(
+                nodeInputs.begin(),
+                nodeInputs.end(),
+                [&need](IImageNode* a, IImageNode* b)
+                {
+                    return need[a] > need[b];
+                });
+            size_t live = 0;
+            size_t peak = 0;
+            for (const auto input : nodeInputs)
+            {
+                peak = std::max(peak, live + need[input]);
+                live += bytes[input];
+            }
+            need[node] = std::max(peak, live + bytes[node]);
+            for (const auto consumer : consumers[node])
+            {
+                if (0 == --waiting[consumer])
+                {
+                    ready.push_back(consumer);
+                }
+            }
+        }
+
+        // Sort the nodes so that each node comes after its inputs.
+        std::map<IImageNode*, size_t> stepIndex;
+        std::set<IImageNode*> visited = { root.get() };
+        std::vector<std::pair<IImageNode*, size_t> > dfs = { { root.get(), 0 } };
+        while (!dfs.empty())
+        {
+            IImageNode* node = dfs.back().first;
+            const std::vector<IImageNode*>& nodeInputs = inputs[node];
+            if (dfs.back().second < nodeInputs.size())
+            {
+                IImageNode* input = nodeInputs[dfs.back().second];
+                ++dfs.back().second;
+                if (visited.insert(input).second)
+                {
+                    dfs.push_back({ input, 0 });
+                }
+            }
+            else
+            {
+                stepIndex[node] = _steps.size();
+                ImagePlanStep step;
+                step.node = sharedNodes[node];
+                step.bytes = bytes[node];
+                _steps.push_back(step);
+                dfs.pop_back();
+            }
+        }
+        for (auto& step : _steps)
+        {
+            for (const auto input : inputs[step.node.get()])
+            {
+                step.inputs.push_back(stepIndex[input]);
+            }
+        }
+
+        // Find the last use of each image.
+        for (size_t i = 0; i < _steps.size(); ++i)
+        {
+            _steps[i].lastUse = i;
+            for (const size_t input : _steps[i].inputs)
+            {
+                _steps[input].lastUse = std::max(_steps[input].lastUse, i);
+            }
+        }
+        if (!_steps.empty())
+        {
+            _steps.back().lastUse = _steps.size();
+        }
+
+        // Assign the images to buffers. A free buffer that is large enough
+        // is preferred, otherwise the largest free buffer is grown.
+        std::vector<size_t> capacity;
+        std::vector<size_t> freeBuffers;
+        size_t live = 0;
+        for (size_t i = 0; i < _steps.size(); ++i)
+        {
+            ImagePlanStep& step = _steps[i];
+            auto best = freeBuffers.end();
+            for (auto j = freeBuffers.begin(); j != freeBuffers.end(); ++j)
+            {
+                if (best == freeBuffers.end())
+                {
+                    best = j;
+                }
+                else
+                {
+                    const bool fits = capacity[*j] >= step.bytes;
+                    const bool bestFits = capacity[*best] >= step.bytes;
+                    if ((fits && !bestFits) ||
+                        (fits && bestFits && capacity[*j] < capacity[*best]) ||
+                        (!fits && !bestFits && capacity[*j] > capacity[*best]))
+                    {
+                        best = j;
+                    }
+                }
+            }
+            if (best != freeBuffers.end())
+            {
+                step.buffer = *best;
+                freeBuffers.erase(best);
+            }
+            else
+            {
+                step.buffer = capacity.size();
+                capacity.push_back(0);
+            }
+            capacity[step.buffer] = std::max(capacity[step.buffer], step.bytes);
+            live += step.bytes;
+            _peakMemory = std::max(_peakMemory, live);
+
+            for (const size_t input : step.inputs)
+            {
+                if (_steps[input].lastUse == i)
+                {
+                    freeBuffers.push_back(_steps[input].buffer);
+                    live -= _steps[input].bytes;
+                }
+            }
+        }
+        _bufferSizes = capacity;
+        _bufferCount = capacity.size();
+    }
+
+    OIIO::ImageBuf ImagePlan::exec(const OIIO::ROI& roi)
+    {
+        OIIO::ImageBuf out;
+        if (_steps.empty())
+        {
+            return out;
+        }
+        const std::shared_ptr<IImageNode> sharedRoot = _steps.back().node;
+        IImageNode* root = sharedRoot.get();
+        IImageNode::EvalScope scope(root);
+
+        // Use the cached image without executing the steps.
+        root->_roi = roi;
+        if (root->_imageCache && root->_imageCache->get(root->_getCacheHash(), out))
+        {
+            return out;
+        }
+
+        ImageArena arena;
+        const std::vector<IImageNode*> nodes = root->_evalInit(roi, &arena);
+
+        // Re-build the plan if the nodes that are needed have changed.
+        const std::set<IImageNode*> nodeSet(nodes.begin(), nodes.end());
+        bool changed = nodeSet.size() != _steps.size();
+        for (size_t i = 0; i < _steps.size() && !changed; ++i)
+        {
+            changed = nodeSet.find(_steps[i].node.get()) == nodeSet.end();
+        }
+        if (changed)
+        {
+            _build(sharedRoot);
+        }
+
+        for (const size_t size : _bufferSizes)
+        {
+            arena.addBuffer(size);
+        }
+        for (size_t i = 0; i < _steps.size(); ++i)
+        {
+            IImageNode* node = _steps[i].node.get();
+            node->_evalBuffer = static_cast<int>(_steps[i].buffer);
+            node->_evalCompute();
+
+            // Release the images that are no longer used.
+            for (const size_t input : _steps[i].inputs)
+            {
+                if (_steps[input].lastUse == i)
+                {
+                    IImageNode* node = _steps[input].node.get();
+                    arena.release(node->_evalBuf);
+                    node->_evalBuf.reset();
+                    node->_evalValid = false;
+                }
+            }
+        }
+        return root->_evalFinish(nodes, arena, root->_eval());
+    }
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <toucanRender/ImageNode.h>
+
+namespace toucan
+{
+    //! Image plan step.
+    struct ImagePlanStep
+    {
+        //! The node that is executed.
+        std::shared_ptr<IImageNode> node;
+
+        //! The steps that produce the inputs of the node.
+        std::vector<size_t> inputs;
+
+        //! The last step that uses the image of the node. The image of the
+        //! last step is used by the caller.
+        size_t lastUse = 0;
+
+        //! The buffer assigned to the image.
+        size_t buffer = 0;
+
+        //! The estimated size of the image in bytes.
+        size_t bytes = 0;
+    };
+
+    //! Image execution plan.
+    //!
+    //! The plan is compiled from the root node of an image graph into a
+    //! list of steps, where each node comes after its inputs. Inputs that
+    //! need more memory are executed first, which keeps the number of
+    //! live images low.
+    //!
+    //! The images are assigned to a small set of buffers that are re-used
+    //! once the images are no longer live, and the predicted peak memory
+    //! is the largest total size of the live images. Image sizes are
+    //! estimated from the region of definition and the format of the
+    //! nodes, or from the given image specification if they are not
+    //! known.
+    class ImagePlan
+    {
+    public:
+        ImagePlan(
+            const std::shared_ptr<IImageNode>&,
+            const OIIO::ImageSpec& = OIIO::ImageSpec());
+
+        ~ImagePlan();
+
+        //! Get the steps.
+        const std::vector<ImagePlanStep>& getSteps() const;
+
+        //! Get the number of buffers.
+        size_t getBufferCount() const;
+
+        //! Get the predicted peak memory in bytes.
+        size_t getPeakMemory() const;
+
+        //! Execute the plan. The steps are executed in order on the
+        //! calling thread, and the image of each step is released after
+        //! its last use. Images are allocated from the buffer assigned to
+        //! their step while it is free. The plan is re-built if the inputs
+        //! that are needed have changed since it was compiled, for example
+        //! because the time of the nodes changed.
+        OIIO::ImageBuf exec(const OIIO::ROI& = OIIO::ROI::All());
+
+    private:
+        void _build(const std::shared_ptr<IImageNode>&);
+
+        OIIO::ImageSpec _spec;
+        std::vector<ImagePlanStep> _steps;
+        std::vector<size_t> _bufferSizes;
+        size_t _bufferCount = 0;
+        size_t _peakMemory = 0;
+    };
+}
@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "MediaPool.h"
+
+#include "Read.h"
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(_WINDOWS)
+#include <stdio.h>
+#else // _WINDOWS
+#include <sys/resource.h>
+#endif // _WINDOWS
+
+namespace toucan
+{
+    namespace
+    {
+        // Half of the file descriptors are reserved for the rest of the
+        // application.
+        size_t getDefaultMaxHandles()
+        {
+            size_t out = 256;
+#if defined(_WINDOWS)
+            out = _getmaxstdio() / 2;
+#else // _WINDOWS
+            struct rlimit limit;
+            if (0 == getrlimit(RLIMIT_NOFILE, &limit) &&
+                limit.rlim_cur != RLIM_INFINITY)
+            {
+                out = static_cast<size_t>(limit.rlim_cur) / 2;
+            }
+#endif // _WINDOWS
+            return out;
+        }
+    }
+
+    MediaPool::MediaPool()
+    {
+        _mutex.maxHandles = getDefaultMaxHandles();
+        _mutex.maxMemory = 1024 * 1024 * 1024;
+    }
+
+    MediaPool::~MediaPool()
+    {}
+
+    std::shared_ptr<MediaPool> MediaPool::get()
+    {
+        static const auto pool = std::make_shared<MediaPool>();
+        return pool;
+    }
+
+    size_t MediaPool::getMaxHandles() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.maxHandles;
+    }
+
+    void MediaPool::setMaxHandles(size_t value)
+    {
+        std::list<Idle> evicted;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            _mutex.maxHandles = value;
+            evicted = _evict();
+        }
+    }
+
+    size_t MediaPool::getMaxMemory() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.maxMemory;
+    }
+
+    void MediaPool::setMaxMemory(size_t value)
+    {
+        std::list<Idle> evicted;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            _mutex.maxMemory = value;
+            evicted = _evict();
+        }
+    }
+
+    std::shared_ptr<IReadNode> MediaPool::checkOut(
+        const std::string& key,
+        const std::function<std::shared_ptr<IReadNode>(void)>& create)
+    {
+        std::shared_ptr<IReadNode> out;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            const auto i = _mutex.index.find(key);
+            if (i != _mutex.index.end())
+            {
+                const auto j = i->second.back();
+                out = j->read;
+                _mutex.stats.memory -= j->memory;
+                i->second.pop_back();
+                if (i->second.empty())
+                {
+                    _mutex.index.erase(i);
+                }
+                _mutex.idle.erase(j);
+                ++_mutex.stats.hits;
+                ++_mutex.stats.checkedOut;
+                return out;
+            }
+            ++_mutex.stats.misses;
+        }
+
+        // Open the media without holding the lock, the new read node is
+        // counted once it has been created.
+        out = create();
+        if (out)
+        {
+            std::list<Idle> evicted;
+            {
+                std::unique_lock<std::mutex> lock(_mutex.mutex);
+                ++_mutex.stats.handles;
+                ++_mutex.stats.checkedOut;
+                evicted = _evict();
+            }
+        }
+        return out;
+    }
+
+    void MediaPool::checkIn(
+        const std::string& key,
+        const std::shared_ptr<IReadNode>& read)
+    {
+        if (!read)
+        {
+            return;
+        }
+        read->setReadAhead(0);
+        Idle idle;
+        idle.key = key;
+        idle.read = read;
+        idle.memory = read->getSpec().image_bytes();
+        std::list<Idle> evicted;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            if (_mutex.stats.checkedOut > 0)
+            {
+                --_mutex.stats.checkedOut;
+            }
+            else
+            {
+                // Adopt read nodes that were not checked out from the pool.
+                ++_mutex.stats.handles;
+            }
+            _mutex.stats.memory += idle.memory;
+            _mutex.idle.push_front(std::move(idle));
+            _mutex.index[key].push_back(_mutex.idle.begin());
+            evicted = _evict();
+        }
+    }
+
+    MediaPoolStats MediaPool::getStats() const
+    {
+        std::unique_lock<std::mutex> lock(_mutex.mutex);
+        return _mutex.stats;
+    }
+
+    void MediaPool::evict(const std::string& prefix)
+    {
+        std::list<Idle> evicted;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            auto i = _mutex.idle.begin();
+            while (i != _mutex.idle.end())
+            {
+                const auto j = i++;
+                if (0 == j->key.compare(0, prefix.size(), prefix))
+                {
+                    _mutex.stats.memory -= j->memory;
+                    --_mutex.stats.handles;
+                    ++_mutex.stats.evictions;
+                    _removeIndex(j);
+                    evicted.splice(evicted.end(), _mutex.idle, j);
+                }
+            }
+        }
+    }
+
+    void MediaPool::clear()
+    {
+        std::list<Idle> evicted;
+        {
+            std::unique_lock<std::mutex> lock(_mutex.mutex);
+            _mutex.stats.evictions += _mutex.idle.size();
+            _mutex.stats.handles -= _mutex.idle.size();
+            _mutex.stats.memory = 0;
+            evicted = std::move(_mutex.idle);
+            _mutex.idle.clear();
+            _mutex.index.clear();
+        }
+    }
+
+    std::list<MediaPool::Idle> MediaPool::_evict()
+    {
+        // The evicted read nodes are returned so that they are closed
+        // after the lock is released.
+        std::list<Idle> out;
+        while (!_mutex.idle.empty() &&
+            (_mutex.stats.handles > _mutex.maxHandles ||
+                _mutex.stats.memory > _mutex.maxMemory))
+        {
+            const auto i = std::prev(_mutex.idle.end());
+            _mutex.stats.memory -= i->memory;
+            --_mutex.stats.handles;
+            ++_mutex.stats.evictions;
+            _removeIndex(i);
+            out.splice(out.begin(), _mutex.idle, i);
+        }
+        return out;
+    }
+
+    void MediaPool::_removeIndex(std::list<Idle>::iterator idle)
+    {
+        const auto i = _mutex.index.find(idle->key);
+        if (i != _mutex.index.end())
+        {
+            // The evicted read node is the least recently used, so it is
+            // found at the front.
+            auto& idles = i->second;
+            const auto j = std::find(idles.begin(), idles.end(), idle);
+            if (j != idles.end())
+            {
+                idles.erase(j);
+            }
+            if (idles.empty())
+            {
+                _mutex.index.erase(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace toucan
+{
+    class IReadNode;
+
+    //! Media pool statistics.
+    struct MediaPoolStats
+    {
+        //! Number of check outs that re-used an open read node.
+        size_t hits = 0;
+
+        //! Number of check outs that opened a new read node.
+        size_t misses = 0;
+
+        //! Number of idle read nodes that were closed.
+        size_t evictions = 0;
+
+        //! Number of open read nodes.
+        size_t handles = 0;
+
+        //! Number of read nodes that are checked out.
+        size_t checkedOut = 0;
+
+        //! Estimated memory used by the idle read nodes in bytes.
+        size_t memory = 0;
+    };
+
+    //! Media pool.
+    //!
+    //! The pool keeps read nodes open so they can be re-used by image
+    //! graphs, thumbnail generators, and exporters that read the same
+    //! media. Read nodes are stored by a key that identifies the resolved
+    //! media, see TimelineWrapper::getMediaKey().
+    //!
+    //! A read node is checked out while it is in use, and checked back in
+    //! when it is no longer needed. Media that is used by several clients
+    //! at the same time gets a separate read node for each, so that they
+    //! do not seek each other's decoders.
+    //!
+    //! Idle read nodes are closed in least recently used order when the
+    //! number of open read nodes exceeds the handle limit, or the memory
+    //! used by the idle read nodes exceeds the memory limit. The default
+    //! handle limit is derived from the process file descriptor limit.
+    class MediaPool : public std::enable_shared_from_this<MediaPool>
+    {
+    public:
+        MediaPool();
+
+        ~MediaPool();
+
+        //! Get the process-wide media pool.
+        static std::shared_ptr<MediaPool> get();
+
+        //! Get the maximum number of open read nodes.
+        size_t getMaxHandles() const;
+
+        //! Set the maximum number of open read nodes.
+        void setMaxHandles(size_t);
+
+        //! Get the maximum memory used by idle read nodes in bytes.
+        size_t getMaxMemory() const;
+
+        //! Set the maximum memory used by idle read nodes in bytes.
+        void setMaxMemory(size_t);
+
+        //! Check out a read node. An idle read node with the same key is
+        //! re-used if available, otherwise the create function is called
+        //! to open a new one. Exceptions from the create function are
+        //! passed to the caller.
+        std::shared_ptr<IReadNode> checkOut(
+            const std::string& key,
+            const std::function<std::shared_ptr<IReadNode>(void)>& create);
+
+        //! Check in a read node. Reading ahead is stopped, and the read
+        //! node is kept open for re-use.
+        void checkIn(
+            const std::string& key,
+            const std::shared_ptr<IReadNode>&);
+
+        //! Get the statistics.
+        MediaPoolStats getStats() const;
+
+        //! Close the idle read nodes with keys that start with the given
+        //! prefix.
+        void evict(const std::string& prefix);
+
+        //! Close the idle read nodes.
+        void clear();
+
+    private:
+        struct Idle
+        {
+            std::string key;
+            std::shared_ptr<IReadNode> read;
+            size_t memory = 0;
+        };
+
+        std::list<Idle> _evict();
+        void _removeIndex(std::list<Idle>::iterator);
+
+        struct Mutex
+        {
+            size_t maxHandles = 0;
+            size_t maxMemory = 0;
+
+            //! The idle read nodes in most recently used order, and indexed
+            //! by key with the most recently used last.
+            std::list<Idle> idle;
+            std::unordered_map<std::string, std::vector<std::list<Idle>::iterator> > index;
+
+            MediaPoolStats stats;
+            std::mutex mutex;
+        };
+        mutable Mutex _mutex;
+    };
+}
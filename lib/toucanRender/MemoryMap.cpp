@@ -3,14 +3,20 @@
 
 #include "MemoryMap.h"
 
+#include "Util.h"
+
 namespace toucan
 {
     MemoryReference::MemoryReference()
     {}
 
-    MemoryReference::MemoryReference(const void* data, size_t size) :
+    MemoryReference::MemoryReference(
+        const void* data,
+        size_t size,
+        const std::shared_ptr<const MemoryMap>& memoryMap) :
         _data(data),
-        _size(size)
+        _size(size),
+        _memoryMap(memoryMap)
     {}
 
     const void* MemoryReference::getData() const
@@ -28,6 +34,82 @@ namespace toucan
         return _data != nullptr;
     }
 
+    namespace
+    {
+        uint16_t getUInt16(const uint8_t* data)
+        {
+            return data[0] | (data[1] << 8);
+        }
+    }
+
+    MemoryReferences::MemoryReferences() :
+        _files(std::make_shared<std::unordered_map<std::string, File> >())
+    {}
+
+    MemoryReferences::MemoryReferences(const std::shared_ptr<const MemoryMap>& memoryMap) :
+        _data(memoryMap ? reinterpret_cast<const uint8_t*>(memoryMap->getData()) : nullptr),
+        _size(memoryMap ? memoryMap->getSize() : 0),
+        _memoryMap(memoryMap),
+        _files(std::make_shared<std::unordered_map<std::string, File> >())
+    {}
+
+    MemoryReferences::MemoryReferences(const void* data, size_t size) :
+        _data(reinterpret_cast<const uint8_t*>(data)),
+        _size(size),
+        _files(std::make_shared<std::unordered_map<std::string, File> >())
+    {}
+
+    void MemoryReferences::add(
+        const std::string& name,
+        uint64_t headerOffset,
+        uint64_t size,
+        bool compressed)
+    {
+        File file;
+        file.headerOffset = headerOffset;
+        file.size = size;
+        file.compressed = compressed;
+        (*_files)[name] = file;
+    }
+
+    bool MemoryReferences::empty() const
+    {
+        return _files->empty();
+    }
+
+    bool MemoryReferences::contains(const std::string& url) const
+    {
+        return _files->find(splitURLProtocol(url).second) != _files->end();
+    }
+
+    MemoryReference MemoryReferences::find(const std::string& url) const
+    {
+        MemoryReference out;
+        const auto i = _files->find(splitURLProtocol(url).second);
+        if (i != _files->end() && !i->second.compressed)
+        {
+            // The local file header is 30 bytes followed by the file name
+            // and the extra field. The lengths may be different from the
+            // central directory.
+            const File& file = i->second;
+            const uint64_t headerSize = 30;
+            if (file.headerOffset + headerSize <= _size)
+            {
+                const uint8_t* header = _data + file.headerOffset;
+                const uint64_t offset =
+                    file.headerOffset +
+                    headerSize +
+                    getUInt16(header + 26) +
+                    getUInt16(header + 28);
+                if (offset + file.size <= _size)
+                {
+                    out = MemoryReference(_data + offset, file.size, _memoryMap);
+                }
+            }
+        }
+        return out;
+    }
+
     std::unique_ptr<OIIO::Filesystem::IOMemReader> getMemoryReader(const MemoryReference& ref)
     {
         return ref.isValid() ?
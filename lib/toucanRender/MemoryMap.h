@@ -5,9 +5,11 @@
 
 #include <OpenImageIO/filesystem.h>
 
+#include <cstdint>
 #include <filesystem>
-#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace toucan
 {
@@ -28,12 +30,17 @@ namespace toucan
         std::unique_ptr<Private> _p;
     };
 
-    //! A reference within a memory mapped file.
+    //! A reference within a memory mapped file. The reference keeps the
+    //! memory map alive, so read nodes that hold it can outlive the
+    //! timeline that opened the file.
     class MemoryReference
     {
     public:
         MemoryReference();
-        MemoryReference(const void* data, size_t size);
+        MemoryReference(
+            const void* data,
+            size_t size,
+            const std::shared_ptr<const MemoryMap>& = nullptr);
 
         const void* getData() const;
 
@@ -44,10 +51,52 @@ namespace toucan
     private:
         const void* _data = nullptr;
         size_t _size = 0;
+        std::shared_ptr<const MemoryMap> _memoryMap;
     };
 
-    //! Map URLs to memory references.
-    typedef std::map<std::string, MemoryReference> MemoryReferences;
+    //! Map URLs to memory references in a memory mapped ZIP archive.
+    //!
+    //! The files are indexed from the central directory of the archive,
+    //! and the memory references are resolved from the local file headers
+    //! when they are used. Copies share the index, so files must be added
+    //! before the references are copied.
+    class MemoryReferences
+    {
+    public:
+        MemoryReferences();
+        MemoryReferences(const std::shared_ptr<const MemoryMap>&);
+        MemoryReferences(const void* data, size_t size);
+
+        //! Add a file from the central directory.
+        void add(
+            const std::string& name,
+            uint64_t headerOffset,
+            uint64_t size,
+            bool compressed);
+
+        //! Get whether there are no files.
+        bool empty() const;
+
+        //! Get whether the archive contains the file for a URL.
+        bool contains(const std::string& url) const;
+
+        //! Get the memory reference for a URL. An invalid reference is
+        //! returned if the file is not found or is compressed.
+        MemoryReference find(const std::string& url) const;
+
+    private:
+        struct File
+        {
+            uint64_t headerOffset = 0;
+            uint64_t size = 0;
+            bool compressed = false;
+        };
+
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+        std::shared_ptr<const MemoryMap> _memoryMap;
+        std::shared_ptr<std::unordered_map<std::string, File> > _files;
+    };
 
     //! Get an OIIO memory reader for a memory reference.
     std::unique_ptr<OIIO::Filesystem::IOMemReader> getMemoryReader(const MemoryReference&);
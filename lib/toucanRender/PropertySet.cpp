@@ -5,11 +5,181 @@
 
 #include <OpenFX/ofxImageEffect.h>
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
 namespace toucan
 {
+    namespace
+    {
+        uint32_t getHash(const char* name)
+        {
+            uint32_t out = 2166136261U;
+            for (const char* c = name; *c; ++c)
+            {
+                out ^= static_cast<unsigned char>(*c);
+                out *= 16777619U;
+            }
+            return out;
+        }
+
+        //! Intern a property name. Each thread keeps a small cache of the
+        //! names it has seen, so the lock is only needed on a cache miss.
+        const char* intern(const char* name, uint32_t hash)
+        {
+            thread_local const char* cache[256] = {};
+            const char*& cached = cache[hash & 255];
+            if (cached && 0 == strcmp(cached, name))
+            {
+                return cached;
+            }
+
+            // The names are never freed, since property sets may be
+            // destroyed after static objects.
+            struct Names
+            {
+                std::unordered_set<std::string> set;
+                std::mutex mutex;
+            };
+            static Names* names = new Names;
+            const char* out = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(names->mutex);
+                out = names->set.insert(name).first->c_str();
+            }
+            cached = out;
+            return out;
+        }
+    }
+
+    // Moving the lists of properties must not copy the string values.
+    static_assert(
+        std::is_nothrow_move_constructible<std::vector<std::string> >::value,
+        "String values must be moved");
+
+    template<typename T, size_t N>
+    size_t PropertySet::Values<T, N>::size() const
+    {
+        return _size;
+    }
+
+    template<typename T, size_t N>
+    void PropertySet::Values<T, N>::resize(size_t size)
+    {
+        if (size > N)
+        {
+            if (_size <= N)
+            {
+                _heap.clear();
+                for (size_t i = 0; i < _size; ++i)
+                {
+                    _heap.push_back(std::move(_inline[i]));
+                }
+                _inline.fill(T());
+            }
+            _heap.resize(size);
+        }
+        else if (_size > N)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                _inline[i] = std::move(_heap[i]);
+            }
+            _heap.clear();
+        }
+        else
+        {
+            for (size_t i = size; i < _size; ++i)
+            {
+                _inline[i] = T();
+            }
+        }
+        _size = size;
+    }
+
+    template<typename T, size_t N>
+    T& PropertySet::Values<T, N>::operator [] (size_t index)
+    {
+        return _size > N ? _heap[index] : _inline[index];
+    }
+
+    template<typename T, size_t N>
+    const T& PropertySet::Values<T, N>::operator [] (size_t index) const
+    {
+        return _size > N ? _heap[index] : _inline[index];
+    }
+
+    template<typename T>
+    const PropertySet::Property<T>* PropertySet::_find(
+        const std::vector<Property<T> >& properties,
+        const char* name)
+    {
+        if (properties.empty())
+        {
+            return nullptr;
+        }
+        const uint32_t hash = getHash(name);
+        for (const auto& property : properties)
+        {
+            if (property.hash == hash && 0 == strcmp(property.name, name))
+            {
+                return &property;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    PropertySet::Values<T>& PropertySet::_get(
+        std::vector<Property<T> >& properties,
+        const char* name)
+    {
+        if (auto property = _find(properties, name))
+        {
+            return const_cast<Property<T>*>(property)->values;
+        }
+        if (properties.empty())
+        {
+            properties.reserve(8);
+        }
+        Property<T> property;
+        property.hash = getHash(name);
+        property.name = intern(name, property.hash);
+        properties.push_back(std::move(property));
+        return properties.back().values;
+    }
+
+    template<typename T>
+    bool PropertySet::_erase(
+        std::vector<Property<T> >& properties,
+        const char* name)
+    {
+        if (auto property = _find(properties, name))
+        {
+            properties.erase(properties.begin() + (property - properties.data()));
+            return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    std::vector<std::string> PropertySet::_getNames(
+        const std::vector<Property<T> >& properties)
+    {
+        std::vector<std::string> out;
+        for (const auto& property : properties)
+        {
+            out.push_back(property.name);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
     OfxStatus PropertySet::setPointer(const char* property, int index, void* value)
     {
-        auto& v = _p[property];
+        auto& v = _get(_p, property);
         if (index >= v.size())
         {
             v.resize(index + 1);
@@ -20,7 +190,7 @@ namespace toucan
 
     OfxStatus PropertySet::setString(const char* property, int index, const char* value)
     {
-        auto& v = _s[property];
+        auto& v = _get(_s, property);
         if (index >= v.size())
         {
             v.resize(index + 1);
@@ -31,7 +201,7 @@ namespace toucan
 
     OfxStatus PropertySet::setDouble(const char* property, int index, double value)
     {
-        auto& v = _d[property];
+        auto& v = _get(_d, property);
         if (index >= v.size())
         {
             v.resize(index + 1);
@@ -42,7 +212,7 @@ namespace toucan
 
     OfxStatus PropertySet::setInt(const char* property, int index, int value)
     {
-        auto& v = _i[property];
+        auto& v = _get(_i, property);
         if (index >= v.size())
         {
             v.resize(index + 1);
@@ -53,7 +223,7 @@ namespace toucan
 
     OfxStatus PropertySet::setPointerN(const char* property, int count, void* const* value)
     {
-        auto& v = _p[property];
+        auto& v = _get(_p, property);
         v.resize(count);
         for (int i = 0; i < count; ++i)
         {
@@ -64,7 +234,7 @@ namespace toucan
 
     OfxStatus PropertySet::setStringN(const char* property, int count, const char* const* value)
     {
-        auto& v = _s[property];
+        auto& v = _get(_s, property);
         v.resize(count);
         for (int i = 0; i < count; ++i)
         {
@@ -75,7 +245,7 @@ namespace toucan
 
     OfxStatus PropertySet::setDoubleN(const char* property, int count, const double* value)
     {
-        auto& v = _d[property];
+        auto& v = _get(_d, property);
         v.resize(count);
         for (int i = 0; i < count; ++i)
         {
@@ -86,7 +256,7 @@ namespace toucan
 
     OfxStatus PropertySet::setIntN(const char* property, int count, const int* value)
     {
-        auto& v = _i[property];
+        auto& v = _get(_i, property);
         v.resize(count);
         for (int i = 0; i < count; ++i)
         {
@@ -97,10 +267,9 @@ namespace toucan
 
     OfxStatus PropertySet::getPointer(const char* property, int index, void** value) const
     {
-        auto p = _p.find(property);
-        if (p != _p.end())
+        if (auto p = _find(_p, property))
         {
-            const auto& v = p->second;
+            const auto& v = p->values;
             if (index < v.size())
             {
                 *value = v[index];
@@ -112,19 +281,14 @@ namespace toucan
 
     OfxStatus PropertySet::getString(const char* property, int index, char** value) const
     {
-        auto s = _s.find(property);
-        if (s != _s.end())
+        if (auto s = _find(_s, property))
         {
-            const auto& v = s->second;
+            const auto& v = s->values;
             if (index < v.size())
             {
-                const auto& string = v[index];
-                const size_t size = string.size();
-                _buf.resize(1);
-                _buf[0].resize(size + 1);
-                memcpy(_buf[0].data(), string.c_str(), size);
-                _buf[0][size] = 0;
-                *value = _buf[0].data();
+                // The string is returned directly so that properties can be
+                // read from multiple render threads.
+                *value = const_cast<char*>(v[index].c_str());
                 return kOfxStatOK;
             }
         }
@@ -133,10 +297,9 @@ namespace toucan
 
     OfxStatus PropertySet::getDouble(const char* property, int index, double* value) const
     {
-        auto d = _d.find(property);
-        if (d != _d.end())
+        if (auto d = _find(_d, property))
         {
-            const auto& v = d->second;
+            const auto& v = d->values;
             if (index < v.size())
             {
                 *value = v[index];
@@ -148,10 +311,9 @@ namespace toucan
 
     OfxStatus PropertySet::getInt(const char* property, int index, int* value) const
     {
-        auto i = _i.find(property);
-        if (i != _i.end())
+        if (auto i = _find(_i, property))
         {
-            const auto& v = i->second;
+            const auto& v = i->values;
             if (index < v.size())
             {
                 *value = v[index];
@@ -163,10 +325,9 @@ namespace toucan
 
     OfxStatus PropertySet::getPointerN(const char* property, int count, void** value) const
     {
-        auto p = _p.find(property);
-        if (p != _p.end())
+        if (auto p = _find(_p, property))
         {
-            const auto& v = p->second;
+            const auto& v = p->values;
             if (count == v.size())
             {
                 for (int i = 0; i < count; ++i)
@@ -181,20 +342,14 @@ namespace toucan
 
     OfxStatus PropertySet::getStringN(const char* property, int count, char** value) const
     {
-        auto s = _s.find(property);
-        if (s != _s.end())
+        if (auto s = _find(_s, property))
         {
-            const auto& v = s->second;
+            const auto& v = s->values;
             if (count == v.size())
             {
-                _buf.resize(count);
                 for (int i = 0; i < count; ++i)
                 {
-                    const size_t size = v[i].size();
-                    _buf[i].resize(size + 1);
-                    memcpy(_buf[i].data(), v[i].c_str(), size);
-                    _buf[i][size] = 0;
-                    value[i] = _buf[i].data();
+                    value[i] = const_cast<char*>(v[i].c_str());
                 }
                 return kOfxStatOK;
             }
@@ -204,10 +359,9 @@ namespace toucan
 
     OfxStatus PropertySet::getDoubleN(const char* property, int count, double* value) const
     {
-        auto d = _d.find(property);
-        if (d != _d.end())
+        if (auto d = _find(_d, property))
         {
-            const auto& v = d->second;
+            const auto& v = d->values;
             if (count == v.size())
             {
                 for (int i = 0; i < count; ++i)
@@ -222,10 +376,9 @@ namespace toucan
 
     OfxStatus PropertySet::getIntN(const char* property, int count, int* value) const
     {
-        auto i = _i.find(property);
-        if (i != _i.end())
+        if (auto p = _find(_i, property))
         {
-            const auto& v = i->second;
+            const auto& v = p->values;
             if (count == v.size())
             {
                 for (int i = 0; i < count; ++i)
@@ -241,28 +394,20 @@ namespace toucan
     OfxStatus PropertySet::reset(const char* property)
     {
         OfxStatus out = kOfxStatFailed;
-        auto p = _p.find(property);
-        if (p != _p.end())
+        if (_erase(_p, property))
         {
-            _p.erase(p);
             out = kOfxStatOK;
         }
-        auto s = _s.find(property);
-        if (s != _s.end())
+        if (_erase(_s, property))
         {
-            _s.erase(s);
             out = kOfxStatOK;
         }
-        auto d = _d.find(property);
-        if (d != _d.end())
+        if (_erase(_d, property))
         {
-            _d.erase(d);
             out = kOfxStatOK;
         }
-        auto i = _i.find(property);
-        if (i != _i.end())
+        if (_erase(_i, property))
         {
-            _i.erase(i);
             out = kOfxStatOK;
         }
         return out;
@@ -271,28 +416,24 @@ namespace toucan
     OfxStatus PropertySet::getDimension(const char* property, int* count) const
     {
         OfxStatus out = kOfxStatFailed;
-        auto p = _p.find(property);
-        if (p != _p.end())
+        if (auto p = _find(_p, property))
         {
-            *count = p->second.size();
+            *count = p->values.size();
             out = kOfxStatOK;
         }
-        auto s = _s.find(property);
-        if (s != _s.end())
+        if (auto s = _find(_s, property))
         {
-            *count = s->second.size();
+            *count = s->values.size();
             out = kOfxStatOK;
         }
-        auto d = _d.find(property);
-        if (d != _d.end())
+        if (auto d = _find(_d, property))
         {
-            *count = d->second.size();
+            *count = d->values.size();
             out = kOfxStatOK;
         }
-        auto i = _i.find(property);
-        if (i != _i.end())
+        if (auto i = _find(_i, property))
         {
-            *count = i->second.size();
+            *count = i->values.size();
             out = kOfxStatOK;
         }
         return out;
@@ -300,42 +441,22 @@ namespace toucan
 
     std::vector<std::string> PropertySet::getPointerProperties() const
     {
-        std::vector<std::string> out;
-        for (const auto& p : _p)
-        {
-            out.push_back(p.first);
-        }
-        return out;
+        return _getNames(_p);
     }
 
     std::vector<std::string> PropertySet::getStringProperties() const
     {
-        std::vector<std::string> out;
-        for (const auto& s : _s)
-        {
-            out.push_back(s.first);
-        }
-        return out;
+        return _getNames(_s);
     }
 
     std::vector<std::string> PropertySet::getDoubleProperties() const
     {
-        std::vector<std::string> out;
-        for (const auto& d : _d)
-        {
-            out.push_back(d.first);
-        }
-        return out;
+        return _getNames(_d);
     }
 
     std::vector<std::string> PropertySet::getIntProperties() const
     {
-        std::vector<std::string> out;
-        for (const auto& i : _i)
-        {
-            out.push_back(i.first);
-        }
-        return out;
+        return _getNames(_i);
     }
 
     OfxStatus PropertySet::setPointer(OfxPropertySetHandle handle, const char* property, int index, void* value)
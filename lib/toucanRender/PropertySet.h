@@ -7,13 +7,21 @@
 
 #include <OpenImageIO/imagebuf.h>
 
-#include <map>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace toucan
 {
     //! OpenFX properties.
+    //!
+    //! The properties are stored in flat lists, one for each type. Property
+    //! names are interned, so a name is stored once per process and the
+    //! properties only keep a pointer to it. Properties are found by
+    //! comparing the name hashes before the strings, and getting a property
+    //! does not allocate memory.
     class PropertySet
     {
     public:
@@ -61,11 +69,47 @@ namespace toucan
         static OfxStatus getDimension(OfxPropertySetHandle, const char* property, int* count);
 
     private:
-        std::map<std::string, std::vector<void*> > _p;
-        std::map<std::string, std::vector<std::string> > _s;
-        mutable std::vector<std::vector<char> > _buf;
-        std::map<std::string, std::vector<double> > _d;
-        std::map<std::string, std::vector<int> > _i;
+        //! Property values. Most properties have a few values, so the
+        //! first values are stored inline. String values are always stored
+        //! on the heap, so the pointers returned by getString() stay valid
+        //! when other properties are set or reset and the lists move.
+        template<typename T, size_t N = std::is_same<T, std::string>::value ? 0 : 4>
+        class Values
+        {
+        public:
+            size_t size() const;
+            void resize(size_t);
+
+            T& operator [] (size_t);
+            const T& operator [] (size_t) const;
+
+        private:
+            std::array<T, N> _inline = {};
+            std::vector<T> _heap;
+            size_t _size = 0;
+        };
+
+        template<typename T>
+        struct Property
+        {
+            const char* name = nullptr;
+            uint32_t hash = 0;
+            Values<T> values;
+        };
+
+        template<typename T>
+        static const Property<T>* _find(const std::vector<Property<T> >&, const char*);
+        template<typename T>
+        static Values<T>& _get(std::vector<Property<T> >&, const char*);
+        template<typename T>
+        static bool _erase(std::vector<Property<T> >&, const char*);
+        template<typename T>
+        static std::vector<std::string> _getNames(const std::vector<Property<T> >&);
+
+        std::vector<Property<void*> > _p;
+        std::vector<Property<std::string> > _s;
+        std::vector<Property<double> > _d;
+        std::vector<Property<int> > _i;
     };
 
     //! Convert to a property set.
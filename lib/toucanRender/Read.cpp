@@ -3,15 +3,73 @@
 
 #include "Read.h"
 
+#include "ImageArena.h"
 #include "TimelineWrapper.h"
 #include "Util.h"
 
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <fstream>
 #include <sstream>
 
 namespace toucan
 {
+    namespace
+    {
+        OIIO::ImageBuf readImage(
+            OIIO::ImageInput* input,
+            const OIIO::ROI& roi,
+            ImageArena* arena)
+        {
+            // Read the pixels directly into the output image. Images with
+            // three channels are read into the first three channels of an
+            // RGBA image. Only the scanlines in the region of interest are
+            // read. The output image starts at the origin of the data
+            // window, so the scanlines are offset by it.
+            const auto& spec = input->spec();
+            const int nchannels = 3 == spec.nchannels ? 4 : spec.nchannels;
+            OIIO::ImageBuf out = allocateImage(
+                arena,
+                OIIO::ImageSpec(spec.width, spec.height, nchannels, spec.format),
+                OIIO::InitializePixels::No);
+            const OIIO::stride_t xstride = nchannels * spec.channel_bytes();
+            const OIIO::stride_t ystride = spec.width * xstride;
+            OIIO::ROI readROI(0, spec.width, 0, spec.height);
+            if (roi.defined())
+            {
+                readROI = OIIO::roi_intersection(roi, readROI);
+            }
+            if (readROI.height() > 0 &&
+                !input->read_scanlines(
+                    0,
+                    0,
+                    spec.y + readROI.ybegin,
+                    spec.y + readROI.yend,
+                    spec.z,
+                    0,
+                    spec.nchannels,
+                    spec.format,
+                    static_cast<char*>(out.localpixels()) + readROI.ybegin * ystride,
+                    xstride,
+                    ystride))
+            {
+                std::stringstream ss;
+                ss << "Cannot read image: " << input->geterror();
+                throw std::runtime_error(ss.str());
+            }
+            if (3 == spec.nchannels)
+            {
+                // Fill the alpha channel.
+                const float alpha[] = { 0.F, 0.F, 0.F, 1.F };
+                OIIO::ImageBufAlgo::fill(
+                    out,
+                    alpha,
+                    OIIO::ROI(0, spec.width, 0, spec.height, 0, 1, 3, 4));
+            }
+            return out;
+        }
+    }
+
     IReadNode::IReadNode(const std::string& name) :
         IImageNode(name)
     {}
@@ -29,11 +87,110 @@ namespace toucan
         return _timeRange;
     }
 
+    std::size_t IReadNode::getHash() const
+    {
+        return getFrameHash(_time);
+    }
+
+    std::size_t IReadNode::getFrameHash(const OTIO_NS::RationalTime&) const
+    {
+        return IImageNode::getHash();
+    }
+
+    OIIO::ROI IReadNode::getRegionOfDefinition() const
+    {
+        OIIO::ROI out;
+        if (_spec.width > 0 && _spec.height > 0)
+        {
+            out = OIIO::ROI(0, _spec.width, 0, _spec.height);
+        }
+        return out;
+    }
+
+    bool IReadNode::isOpaque() const
+    {
+        return 3 == _spec.nchannels && _spec.alpha_channel < 0;
+    }
+
+    OIIO::TypeDesc IReadNode::getFormat() const
+    {
+        return _spec.format;
+    }
+
+    void IReadNode::setReadAhead(size_t value, int direction)
+    {
+        std::unique_lock<std::mutex> lock(_readMutex);
+        _setReadAhead(value, direction);
+    }
+
+    OIIO::ImageBuf IReadNode::read(
+        const OTIO_NS::RationalTime& time,
+        const OIIO::ROI& roi,
+        ImageArena* arena)
+    {
+        std::unique_lock<std::mutex> lock(_readMutex);
+        _time = time;
+        _roi = roi;
+        _arena = arena;
+        return _exec();
+    }
+
+    void IReadNode::_setReadAhead(size_t, int)
+    {}
+
+    ReadFrameNode::ReadFrameNode(
+        const std::shared_ptr<IReadNode>& read,
+        const OTIO_NS::RationalTime& time) :
+        IImageNode("ReadFrame"),
+        _read(read)
+    {
+        _time = time;
+    }
+
+    ReadFrameNode::~ReadFrameNode()
+    {}
+
+    const std::shared_ptr<IReadNode>& ReadFrameNode::getReadNode() const
+    {
+        return _read;
+    }
+
+    std::string ReadFrameNode::getLabel() const
+    {
+        return _read->getLabel();
+    }
+
+    std::size_t ReadFrameNode::getHash() const
+    {
+        return _read->getFrameHash(_time);
+    }
+
+    OIIO::ROI ReadFrameNode::getRegionOfDefinition() const
+    {
+        return _read->getRegionOfDefinition();
+    }
+
+    bool ReadFrameNode::isOpaque() const
+    {
+        return _read->isOpaque();
+    }
+
+    OIIO::TypeDesc ReadFrameNode::getFormat() const
+    {
+        return _read->getFormat();
+    }
+
+    OIIO::ImageBuf ReadFrameNode::_exec()
+    {
+        return _read->read(_time, _roi, _arena);
+    }
+
     ImageReadNode::ImageReadNode(
         const std::filesystem::path& path,
         const MemoryReference& memoryReference) :
         IReadNode("ImageRead"),
         _path(path),
+        _memoryReference(memoryReference),
         _memoryReader(getMemoryReader(memoryReference))
     {
         _input = OIIO::ImageInput::open(_path.string(), nullptr, _memoryReader.get());
@@ -61,45 +218,18 @@ namespace toucan
         return ss.str();
     }
 
-    OIIO::ImageBuf ImageReadNode::exec()
+    std::size_t ImageReadNode::getFrameHash(const OTIO_NS::RationalTime&) const
     {
-        OIIO::ImageBuf out;
-
-        // Read the image.
-        auto pixels = std::unique_ptr<unsigned char[]>(
-            new unsigned char[_spec.width * _spec.height * _spec.nchannels * _spec.channel_bytes()]);
-        _input->read_image(
-            0,
-            0,
-            0,
-            _spec.nchannels,
-            _spec.format,
-            &pixels[0]);
-
-        OIIO::ImageBuf buf(
-            OIIO::ImageSpec(_spec.width, _spec.height, _spec.nchannels, _spec.format),
-            pixels.get(),
-            _spec.nchannels * _spec.channel_bytes(),
-            _spec.width * _spec.nchannels * _spec.channel_bytes(),
-            0);
-
-        const auto& spec = buf.spec();
-        if (3 == spec.nchannels)
-        {
-            // Add an alpha channel.
-            const int channelOrder[] = { 0, 1, 2, -1 };
-            const float channelValues[] = { 0, 0, 0, 1.0 };
-            const std::string channelNames[] = { "", "", "", "A" };
-            out = OIIO::ImageBufAlgo::channels(buf, 4, channelOrder, channelValues, channelNames);
-        }
-        else
-        {
-            OIIO::ImageBufAlgo::copy(out, buf);
-        }
-
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, std::hash<std::string>()(_path.string()));
         return out;
     }
 
+    OIIO::ImageBuf ImageReadNode::_exec()
+    {
+        return readImage(_input.get(), _roi, _arena);
+    }
+
     std::vector<std::string> ImageReadNode::getExtensions()
     {
         return { ".exr", ".tif", ".tiff", ".jpg", ".jpeg", ".png" };
@@ -131,15 +261,10 @@ namespace toucan
             _startFrame,
             _frameZeroPadding,
             _nameSuffix);
-        std::unique_ptr<OIIO::Filesystem::IOMemReader> memoryReader;
-        const auto i = _memoryReferences.find(url);
-        if (i != _memoryReferences.end() && i->second.isValid())
+        if (_open(url))
         {
-            memoryReader = getMemoryReader(i->second);
-        }
-        if (auto input = OIIO::ImageInput::open(url, nullptr, memoryReader.get()))
-        {
-            _spec = input->spec();
+            _spec = _input->spec();
+            _input->close();
         }
         _timeRange = OTIO_NS::TimeRange(
             OTIO_NS::RationalTime(_startFrame, _rate),
@@ -147,7 +272,9 @@ namespace toucan
     }
 
     SequenceReadNode::~SequenceReadNode()
-    {}
+    {
+        _prefetchStop();
+    }
 
     std::string SequenceReadNode::getLabel() const
     {
@@ -161,58 +288,222 @@ namespace toucan
         return ss.str();
     }
 
-    OIIO::ImageBuf SequenceReadNode::exec()
+    std::size_t SequenceReadNode::getFrameHash(const OTIO_NS::RationalTime& time) const
     {
-        OIIO::ImageBuf out;
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, std::hash<std::string>()(getSequenceFrame(
+            _base,
+            _namePrefix,
+            time.to_frames(),
+            _frameZeroPadding,
+            _nameSuffix)));
+        return out;
+    }
 
-        // Open the sequence file.
+    OIIO::ImageBuf SequenceReadNode::_exec()
+    {
+        OIIO::ImageBuf out;
         const std::string url = getSequenceFrame(
             _base,
             _namePrefix,
             _time.to_frames(),
             _frameZeroPadding,
             _nameSuffix);
-        std::unique_ptr<OIIO::Filesystem::IOMemReader> memoryReader;
-        const auto i = _memoryReferences.find(url);
-        if (i != _memoryReferences.end() && i->second.isValid())
+        _prefetch(_time.to_frames());
+        if (_open(url))
         {
-            memoryReader = getMemoryReader(i->second);
+            out = readImage(_input.get(), _roi, _arena);
+            _input->close();
         }
-        if (auto input = OIIO::ImageInput::open(url, nullptr, memoryReader.get()))
+        _prefetchData.reset();
+        return out;
+    }
+
+    void SequenceReadNode::_setReadAhead(size_t value, int direction)
+    {
+        if (value == _readAhead && direction == _readAheadDirection)
         {
-            // Read the image.
-            const auto& spec = input->spec();
-            auto pixels = std::unique_ptr<unsigned char[]>(
-                new unsigned char[spec.width * spec.height * spec.nchannels * spec.channel_bytes()]);
-            input->read_image(
-                0,
-                0,
-                0,
-                spec.nchannels,
-                spec.format,
-                &pixels[0]);
-
-            OIIO::ImageBuf buf(
-                OIIO::ImageSpec(spec.width, spec.height, spec.nchannels, spec.format),
-                pixels.get(),
-                spec.nchannels * spec.channel_bytes(),
-                spec.width * spec.nchannels * spec.channel_bytes(),
-                0);
-            if (3 == spec.nchannels)
+            return;
+        }
+        _prefetchStop();
+        _readAhead = value;
+        _readAheadDirection = direction;
+        if (_readAhead > 0 && _memoryReferences.empty())
+        {
+            {
+                std::unique_lock<std::mutex> lock(_prefetchMutex.mutex);
+                _prefetchMutex.running = true;
+            }
+            _prefetchThread = std::thread(
+                [this]
+                {
+                    _prefetchRun();
+                });
+        }
+    }
+
+    bool SequenceReadNode::_open(const std::string& url)
+    {
+        _memoryReader.reset();
+        const MemoryReference mem = _memoryReferences.find(url);
+        if (mem.isValid())
+        {
+            _memoryReader = getMemoryReader(mem);
+        }
+        else if (_prefetchData)
+        {
+            _memoryReader = std::make_unique<OIIO::Filesystem::IOMemReader>(
+                _prefetchData->data(),
+                _prefetchData->size());
+        }
+
+        // Re-use the image input from the previous frame, the frames of a
+        // sequence all have the same format.
+        bool out = false;
+        if (_input)
+        {
+            OIIO::ImageSpec spec;
+            out =
+                _input->set_ioproxy(_memoryReader.get()) &&
+                _input->open(url, spec);
+        }
+        if (!out)
+        {
+            _input = OIIO::ImageInput::open(url, nullptr, _memoryReader.get());
+            out = _input.get();
+        }
+        if (!out && _prefetchData)
+        {
+            // The format cannot be read from memory, read the file instead.
+            _prefetchData.reset();
+            _memoryReader.reset();
+            _input = OIIO::ImageInput::open(url);
+            out = _input.get();
+        }
+        return out;
+    }
+
+    void SequenceReadNode::_prefetch(int64_t frame)
+    {
+        if (!_prefetchThread.joinable())
+        {
+            return;
+        }
+
+        // Request the next frames in the playback direction, and discard
+        // the frames that are no longer needed.
+        const std::string url = getSequenceFrame(
+            _base,
+            _namePrefix,
+            frame,
+            _frameZeroPadding,
+            _nameSuffix);
+        std::unique_lock<std::mutex> lock(_prefetchMutex.mutex);
+        _prefetchMutex.requests.clear();
+        _prefetchMutex.window.clear();
+        _prefetchMutex.window.insert(url);
+        for (size_t i = 1; i <= _readAhead; ++i)
+        {
+            const std::string nextURL = getSequenceFrame(
+                _base,
+                _namePrefix,
+                frame + static_cast<int64_t>(i) * _readAheadDirection,
+                _frameZeroPadding,
+                _nameSuffix);
+            _prefetchMutex.window.insert(nextURL);
+            if (_prefetchMutex.files.find(nextURL) == _prefetchMutex.files.end())
+            {
+                _prefetchMutex.requests.push_back(nextURL);
+            }
+        }
+        auto i = _prefetchMutex.files.begin();
+        while (i != _prefetchMutex.files.end())
+        {
+            if (_prefetchMutex.window.find(i->first) == _prefetchMutex.window.end())
             {
-                // Add an alpha channel.
-                const int channelOrder[] = { 0, 1, 2, -1 };
-                const float channelValues[] = { 0, 0, 0, 1.0 };
-                const std::string channelNames[] = { "", "", "", "A" };
-                out = OIIO::ImageBufAlgo::channels(buf, 4, channelOrder, channelValues, channelNames);
+                i = _prefetchMutex.files.erase(i);
             }
             else
             {
-                OIIO::ImageBufAlgo::copy(out, buf);
+                ++i;
             }
         }
 
-        return out;
+        // Use the prefetched data for the current frame if it is ready.
+        const auto j = _prefetchMutex.files.find(url);
+        if (j != _prefetchMutex.files.end())
+        {
+            _prefetchData = j->second;
+        }
+        lock.unlock();
+        _prefetchCV.notify_one();
+    }
+
+    void SequenceReadNode::_prefetchRun()
+    {
+        while (1)
+        {
+            std::string url;
+            {
+                std::unique_lock<std::mutex> lock(_prefetchMutex.mutex);
+                _prefetchCV.wait(
+                    lock,
+                    [this]
+                    {
+                        return
+                            !_prefetchMutex.running ||
+                            !_prefetchMutex.requests.empty();
+                    });
+                if (!_prefetchMutex.running)
+                {
+                    break;
+                }
+                url = _prefetchMutex.requests.front();
+                _prefetchMutex.requests.pop_front();
+            }
+
+            // Read the file into memory.
+            std::shared_ptr<std::vector<char> > data;
+            std::ifstream file(url, std::ios::binary | std::ios::ate);
+            if (file.is_open())
+            {
+                const std::streamsize size = file.tellg();
+                if (size > 0)
+                {
+                    file.seekg(0, std::ios::beg);
+                    data = std::make_shared<std::vector<char> >(size);
+                    if (!file.read(data->data(), size))
+                    {
+                        data.reset();
+                    }
+                }
+            }
+
+            if (data)
+            {
+                std::unique_lock<std::mutex> lock(_prefetchMutex.mutex);
+                if (_prefetchMutex.window.find(url) != _prefetchMutex.window.end())
+                {
+                    _prefetchMutex.files[url] = data;
+                }
+            }
+        }
+    }
+
+    void SequenceReadNode::_prefetchStop()
+    {
+        if (_prefetchThread.joinable())
+        {
+            {
+                std::unique_lock<std::mutex> lock(_prefetchMutex.mutex);
+                _prefetchMutex.running = false;
+                _prefetchMutex.requests.clear();
+                _prefetchMutex.window.clear();
+                _prefetchMutex.files.clear();
+            }
+            _prefetchCV.notify_all();
+            _prefetchThread.join();
+        }
     }
 
     std::vector<std::string> SequenceReadNode::getExtensions()
@@ -259,7 +550,14 @@ namespace toucan
         return ss.str();
     }
 
-    OIIO::ImageBuf SVGReadNode::exec()
+    std::size_t SVGReadNode::getFrameHash(const OTIO_NS::RationalTime&) const
+    {
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, std::hash<std::string>()(_path.string()));
+        return out;
+    }
+
+    OIIO::ImageBuf SVGReadNode::_exec()
     {
         OIIO::ImageBuf out;
         
@@ -268,7 +566,7 @@ namespace toucan
         auto bitmap = _svg->renderToBitmap(w, h, 0x00000000);
         if (!bitmap.isNull())
         {
-            out = OIIO::ImageBuf(_spec);
+            out = _allocateImage(_spec, OIIO::InitializePixels::No);
             for (int y = 0; y < h; ++y)
             {
                 uint8_t* imageP = reinterpret_cast<uint8_t*>(out.localpixels()) + y * w * 4;
@@ -313,24 +611,30 @@ namespace toucan
         return ss.str();
     }
 
-    OIIO::ImageBuf MovieReadNode::exec()
+    std::size_t MovieReadNode::getFrameHash(const OTIO_NS::RationalTime& time) const
     {
-        OIIO::ImageBuf out;
+        std::size_t out = IImageNode::getHash();
+        hashCombine(out, std::hash<std::string>()(_path.string()));
+        hashCombine(out, std::hash<double>()(time.to_seconds()));
+        return out;
+    }
 
-        // Read the image.
-        out = _ffRead->getImage(_time);
+    bool MovieReadNode::isOpaque() const
+    {
+        return _ffRead->isOpaque();
+    }
 
-        const auto& spec = out.spec();
-        if (3 == spec.nchannels)
-        {
-            // Add an alpha channel.
-            const int channelOrder[] = { 0, 1, 2, -1 };
-            const float channelValues[] = { 0, 0, 0, 1.0 };
-            const std::string channelNames[] = { "", "", "", "A" };
-            out = OIIO::ImageBufAlgo::channels(out, 4, channelOrder, channelValues, channelNames);
-        }
+    void MovieReadNode::_setReadAhead(size_t value, int direction)
+    {
+        // Movies are only decoded ahead for forward playback.
+        _ffRead->setReadAhead(direction > 0 ? value : 0);
+    }
 
-        return out;
+    OIIO::ImageBuf MovieReadNode::_exec()
+    {
+        // Movies are converted to RGBA or gray images, so an alpha channel
+        // does not need to be added.
+        return _ffRead->getImage(_time, _arena);
     }
 
     std::vector<std::string> MovieReadNode::getExtensions()
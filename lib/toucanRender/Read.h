@@ -11,7 +11,13 @@
 
 #include <OpenImageIO/filesystem.h>
 
+#include <condition_variable>
 #include <filesystem>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 namespace toucan
 {
@@ -27,9 +33,71 @@ namespace toucan
 
         const OTIO_NS::TimeRange& getTimeRange() const;
 
+        std::size_t getHash() const override;
+
+        //! Get a hash of the image at the given time.
+        virtual std::size_t getFrameHash(const OTIO_NS::RationalTime&) const;
+
+        OIIO::ROI getRegionOfDefinition() const override;
+
+        //! Images without an alpha channel are opaque.
+        bool isOpaque() const override;
+
+        OIIO::TypeDesc getFormat() const override;
+
+        //! Set the number of frames to read ahead in the background. Zero
+        //! disables reading ahead. The direction is 1 for forward playback
+        //! and -1 for reverse playback.
+        void setReadAhead(size_t, int direction = 1);
+
+        //! Read the image at the given time. This can be called from
+        //! multiple threads, so that a read node can be shared by image
+        //! graphs that are executed concurrently. The image is allocated
+        //! from the arena if one is given.
+        OIIO::ImageBuf read(
+            const OTIO_NS::RationalTime&,
+            const OIIO::ROI& = OIIO::ROI::All(),
+            ImageArena* = nullptr);
+
     protected:
+        virtual void _setReadAhead(size_t, int direction);
+
         OIIO::ImageSpec _spec;
         OTIO_NS::TimeRange _timeRange;
+
+    private:
+        std::mutex _readMutex;
+    };
+
+    //! Read frame node. This node reads a frame from a shared read node,
+    //! the read node holds the open file while this node holds the time.
+    class ReadFrameNode : public IImageNode
+    {
+    public:
+        ReadFrameNode(
+            const std::shared_ptr<IReadNode>&,
+            const OTIO_NS::RationalTime&);
+
+        virtual ~ReadFrameNode();
+
+        //! Get the read node.
+        const std::shared_ptr<IReadNode>& getReadNode() const;
+
+        std::string getLabel() const override;
+
+        std::size_t getHash() const override;
+
+        OIIO::ROI getRegionOfDefinition() const override;
+
+        bool isOpaque() const override;
+
+        OIIO::TypeDesc getFormat() const override;
+
+    protected:
+        OIIO::ImageBuf _exec() override;
+
+    private:
+        std::shared_ptr<IReadNode> _read;
     };
 
     //! Image read node.
@@ -44,12 +112,16 @@ namespace toucan
 
         std::string getLabel() const override;
 
-        OIIO::ImageBuf exec() override;
+        std::size_t getFrameHash(const OTIO_NS::RationalTime&) const override;
 
         static std::vector<std::string> getExtensions();
 
+    protected:
+        OIIO::ImageBuf _exec() override;
+
     private:
         std::filesystem::path _path;
+        MemoryReference _memoryReference;
         std::shared_ptr<OIIO::Filesystem::IOMemReader> _memoryReader;
         std::unique_ptr<OIIO::ImageInput> _input;
     };
@@ -72,11 +144,22 @@ namespace toucan
 
         std::string getLabel() const override;
 
-        OIIO::ImageBuf exec() override;
+        std::size_t getFrameHash(const OTIO_NS::RationalTime&) const override;
 
         static std::vector<std::string> getExtensions();
 
+    protected:
+        OIIO::ImageBuf _exec() override;
+
+        //! Prefetch frame files into memory in the background.
+        void _setReadAhead(size_t, int direction) override;
+
     private:
+        bool _open(const std::string&);
+        void _prefetch(int64_t frame);
+        void _prefetchRun();
+        void _prefetchStop();
+
         std::string _base;
         std::string _namePrefix;
         std::string _nameSuffix;
@@ -85,6 +168,23 @@ namespace toucan
         double _rate = 1.0;
         int _frameZeroPadding = 0;
         MemoryReferences _memoryReferences;
+        std::unique_ptr<OIIO::Filesystem::IOMemReader> _memoryReader;
+        std::unique_ptr<OIIO::ImageInput> _input;
+
+        size_t _readAhead = 0;
+        int _readAheadDirection = 1;
+        std::shared_ptr<std::vector<char> > _prefetchData;
+        struct PrefetchMutex
+        {
+            std::list<std::string> requests;
+            std::set<std::string> window;
+            std::map<std::string, std::shared_ptr<std::vector<char> > > files;
+            bool running = false;
+            std::mutex mutex;
+        };
+        PrefetchMutex _prefetchMutex;
+        std::condition_variable _prefetchCV;
+        std::thread _prefetchThread;
     };
 
     //! SVG read node.
@@ -99,10 +199,13 @@ namespace toucan
 
         std::string getLabel() const override;
 
-        OIIO::ImageBuf exec() override;
+        std::size_t getFrameHash(const OTIO_NS::RationalTime&) const override;
 
         static std::vector<std::string> getExtensions();
 
+    protected:
+        OIIO::ImageBuf _exec() override;
+
     private:
         std::filesystem::path _path;
         std::unique_ptr<lunasvg::Document> _svg;
@@ -120,10 +223,18 @@ namespace toucan
 
         std::string getLabel() const override;
 
-        OIIO::ImageBuf exec() override;
+        std::size_t getFrameHash(const OTIO_NS::RationalTime&) const override;
+
+        //! Movies are decoded to RGBA, so the image is opaque if the video
+        //! stream does not have an alpha channel.
+        bool isOpaque() const override;
 
         static std::vector<std::string> getExtensions();
 
+    protected:
+        OIIO::ImageBuf _exec() override;
+        void _setReadAhead(size_t, int direction) override;
+
     private:
         std::filesystem::path _path;
         std::shared_ptr<OIIO::Filesystem::IOMemReader> _memoryReader;
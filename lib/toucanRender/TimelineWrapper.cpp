@@ -5,6 +5,7 @@
 
 #include "Util.h"
 
+#include <toucanRender/MediaPool.h>
 #include <toucanRender/Read.h>
 
 #include <ftk/Core/String.h>
@@ -13,10 +14,14 @@
 #include <opentimelineio/externalReference.h>
 #include <opentimelineio/imageSequenceReference.h>
 
+#include <mz.h>
 #include <mz_zip.h>
 #include <mz_strm.h>
 #include <mz_zip_rw.h>
 
+#include <atomic>
+#include <sstream>
+
 namespace toucan
 {
     namespace
@@ -144,8 +149,15 @@ namespace toucan
                 }
             }*/
 
+            // The keys of the media in the archive are unique to this
+            // timeline, since the paths are relative to the archive.
+            static std::atomic<uint64_t> archiveCount(0);
+            std::stringstream ss;
+            ss << "otioz:" << ++archiveCount << ":";
+            _mediaKeyPrefix = ss.str();
+
             // Open the ZIP and get the .otio file.
-            _memoryMap = std::make_unique<MemoryMap>(path);
+            _memoryMap = std::make_shared<MemoryMap>(path);
             ZipFile zip(_memoryMap->getData(), _memoryMap->getSize());
             int32_t r = mz_zip_reader_locate_entry(zip.handle, "content.otio", 0);
             if (r != 0)
@@ -176,70 +188,52 @@ namespace toucan
                 throw std::runtime_error(errorStatus.full_description);
             }
 
-            // Create memory references for the media files in the ZIP.
+            // Index the files in the ZIP. The memory references are
+            // resolved when they are used, so the index does not depend on
+            // the number of frames in the timeline.
+            _memoryReferences = MemoryReferences(_memoryMap);
+            for (r = mz_zip_reader_goto_first_entry(zip.handle);
+                MZ_OK == r;
+                r = mz_zip_reader_goto_next_entry(zip.handle))
+            {
+                if (MZ_OK == mz_zip_reader_entry_get_info(zip.handle, &zipInfo) && zipInfo->filename)
+                {
+                    _memoryReferences.add(
+                        zipInfo->filename,
+                        zipInfo->disk_offset,
+                        zipInfo->uncompressed_size,
+                        zipInfo->compression_method != 0);
+                }
+            }
+
+            // Check the media files in the ZIP. Only the first frame of
+            // image sequences is checked.
             for (const auto& clip : _timeline->find_clips())
             {
+                std::string url;
                 if (auto externalRef = dynamic_cast<OTIO_NS::ExternalReference*>(clip->media_reference()))
                 {
-                    const std::string url = externalRef->target_url();
-                    auto split = splitURLProtocol(url);
-                    r = mz_zip_reader_locate_entry(zip.handle, split.second.c_str(), 0);
-                    if (r != 0)
-                    {
-                        throw std::runtime_error("Cannot locate: " + split.second);
-                    }
-                    r = mz_zip_reader_entry_get_info(zip.handle, &zipInfo);
-                    if (r != 0)
-                    {
-                        throw std::runtime_error("Cannot get info: " + split.second);
-                    }
-                    if (zipInfo->compression_method != 0)
-                    {
-                        throw std::runtime_error("Media is not uncompressed: " + split.second);
-                    }
-                    const size_t headerSize =
-                        30 +
-                        zipInfo->filename_size +
-                        zipInfo->extrafield_size;
-                    _memoryReferences[url] = MemoryReference(
-                        reinterpret_cast<const uint8_t*>(_memoryMap->getData()) + headerSize + zipInfo->disk_offset,
-                        zipInfo->uncompressed_size);
+                    url = externalRef->target_url();
                 }
                 else if (auto sequenceRef = dynamic_cast<OTIO_NS::ImageSequenceReference*>(clip->media_reference()))
                 {
-                    const OTIO_NS::TimeRange timeRange = clip->available_range();
-                    for (int64_t frame = timeRange.start_time().value();
-                        frame <= timeRange.end_time_inclusive().value();
-                        ++frame)
+                    url = getSequenceFrame(
+                        sequenceRef->target_url_base(),
+                        sequenceRef->name_prefix(),
+                        static_cast<int>(clip->available_range().start_time().value()),
+                        sequenceRef->frame_zero_padding(),
+                        sequenceRef->name_suffix());
+                }
+                if (!url.empty())
+                {
+                    const std::string fileName = splitURLProtocol(url).second;
+                    if (!_memoryReferences.contains(url))
                     {
-                        const std::string url = getSequenceFrame(
-                            sequenceRef->target_url_base(),
-                            sequenceRef->name_prefix(),
-                            frame,
-                            sequenceRef->frame_zero_padding(),
-                            sequenceRef->name_suffix());
-                        const auto split = splitURLProtocol(url);
-                        r = mz_zip_reader_locate_entry(zip.handle, split.second.c_str(), 0);
-                        if (r != 0)
-                        {
-                            throw std::runtime_error("Cannot locate: " + split.second);
-                        }
-                        r = mz_zip_reader_entry_get_info(zip.handle, &zipInfo);
-                        if (r != 0)
-                        {
-                            throw std::runtime_error("Cannot get info: " + split.second);
-                        }
-                        if (zipInfo->compression_method != 0)
-                        {
-                            throw std::runtime_error("Media is not uncompressed: " + split.second);
-                        }
-                        const size_t headerSize =
-                            30 +
-                            zipInfo->filename_size +
-                            zipInfo->extrafield_size;
-                        _memoryReferences[url] = MemoryReference(
-                            reinterpret_cast<const uint8_t*>(_memoryMap->getData()) + headerSize + zipInfo->disk_offset,
-                            zipInfo->uncompressed_size);
+                        throw std::runtime_error("Cannot locate: " + fileName);
+                    }
+                    if (!_memoryReferences.find(url).isValid())
+                    {
+                        throw std::runtime_error("Media is not uncompressed: " + fileName);
                     }
                 }
             }
@@ -318,6 +312,12 @@ namespace toucan
 
     TimelineWrapper::~TimelineWrapper()
     {
+        // Close the idle read nodes for the media in the archive, they
+        // cannot be re-used by another timeline.
+        if (!_mediaKeyPrefix.empty())
+        {
+            MediaPool::get()->evict(_mediaKeyPrefix);
+        }
         //if (!_tmpPath.empty())
         //{
         //    std::filesystem::remove_all(_tmpPath);
@@ -361,6 +361,46 @@ namespace toucan
         return out;
     }
 
+    std::string TimelineWrapper::getMediaKey(const OTIO_NS::MediaReference* ref) const
+    {
+        std::stringstream ss;
+        ss << _mediaKeyPrefix;
+        if (auto externalRef = dynamic_cast<const OTIO_NS::ExternalReference*>(ref))
+        {
+            const std::string path = getMediaPath(externalRef->target_url());
+            ss << path;
+            if (!_memoryMap)
+            {
+                // Files that are edited on disk are not read with the
+                // read nodes of the old file.
+                std::error_code ec;
+                const auto time = std::filesystem::last_write_time(path, ec);
+                if (!ec)
+                {
+                    ss << "@" << time.time_since_epoch().count();
+                }
+                const auto size = std::filesystem::file_size(path, ec);
+                if (!ec)
+                {
+                    ss << ":" << size;
+                }
+            }
+        }
+        else if (auto seqRef = dynamic_cast<const OTIO_NS::ImageSequenceReference*>(ref))
+        {
+            // The frames of a sequence are opened when they are read, so
+            // they are not checked on disk here.
+            ss << getMediaPath(seqRef->target_url_base()) <<
+                seqRef->name_prefix() << "#" <<
+                seqRef->name_suffix() << ":" <<
+                seqRef->start_frame() << ":" <<
+                seqRef->frame_step() << ":" <<
+                seqRef->rate() << ":" <<
+                seqRef->frame_zero_padding();
+        }
+        return ss.str();
+    }
+
     std::shared_ptr<IReadNode> TimelineWrapper::createReadNode(const OTIO_NS::MediaReference* ref)
     {
         std::shared_ptr<IReadNode> out;
@@ -388,7 +428,6 @@ namespace toucan
 
     MemoryReference TimelineWrapper::_getMemoryReference(const std::string& url) const
     {
-        const auto i = _memoryReferences.find(url);
-        return i != _memoryReferences.end() ? i->second : MemoryReference();
+        return _memoryReferences.find(url);
     }
 }
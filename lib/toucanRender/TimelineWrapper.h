@@ -32,6 +32,12 @@ namespace toucan
 
         std::string getMediaPath(const std::string& url) const;
 
+        //! Get a key that identifies the media for a reference. References
+        //! with the same key can share a read node, see MediaPool. Media in
+        //! an .otioz archive is identified by the timeline that opened it,
+        //! and media on disk also by the modification time and size.
+        std::string getMediaKey(const OTIO_NS::MediaReference*) const;
+
         std::shared_ptr<IReadNode> createReadNode(const OTIO_NS::MediaReference*);
 
     private:
@@ -39,8 +45,9 @@ namespace toucan
 
         std::filesystem::path _path;
         //std::filesystem::path _tmpPath;
-        std::unique_ptr<MemoryMap> _memoryMap;
+        std::shared_ptr<MemoryMap> _memoryMap;
         MemoryReferences _memoryReferences;
+        std::string _mediaKeyPrefix;
         OTIO_NS::SerializableObject::Retainer<OTIO_NS::Timeline> _timeline;
         OTIO_NS::TimeRange _timeRange;
     };
@@ -186,6 +186,59 @@ namespace toucan
         }
     }
 
+    void hashCombine(std::size_t& hash, std::size_t value)
+    {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+
+    std::size_t hashAny(const std::any& value)
+    {
+        std::size_t out = std::hash<std::string>()(value.type().name());
+        if (value.type() == typeid(bool))
+        {
+            hashCombine(out, std::hash<bool>()(std::any_cast<bool>(value)));
+        }
+        else if (value.type() == typeid(int))
+        {
+            hashCombine(out, std::hash<int>()(std::any_cast<int>(value)));
+        }
+        else if (value.type() == typeid(int64_t))
+        {
+            hashCombine(out, std::hash<int64_t>()(std::any_cast<int64_t>(value)));
+        }
+        else if (value.type() == typeid(double))
+        {
+            hashCombine(out, std::hash<double>()(std::any_cast<double>(value)));
+        }
+        else if (value.type() == typeid(std::string))
+        {
+            hashCombine(out, std::hash<std::string>()(std::any_cast<std::string>(value)));
+        }
+        else if (value.type() == typeid(OTIO_NS::AnyVector))
+        {
+            for (const auto& i : std::any_cast<const OTIO_NS::AnyVector&>(value))
+            {
+                hashCombine(out, hashAny(i));
+            }
+        }
+        else if (value.type() == typeid(OTIO_NS::AnyDictionary))
+        {
+            hashCombine(out, hashAny(std::any_cast<const OTIO_NS::AnyDictionary&>(value)));
+        }
+        return out;
+    }
+
+    std::size_t hashAny(const OTIO_NS::AnyDictionary& value)
+    {
+        std::size_t out = 0;
+        for (const auto& i : value)
+        {
+            hashCombine(out, std::hash<std::string>()(i.first));
+            hashCombine(out, hashAny(i.second));
+        }
+        return out;
+    }
+
     std::vector<std::filesystem::path> getOpenFXPluginPaths(
         const std::filesystem::path& executablePath)
     {
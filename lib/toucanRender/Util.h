@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <opentimelineio/anyDictionary.h>
 #include <opentimelineio/anyVector.h>
 
 #include <Imath/ImathBox.h>
@@ -49,6 +50,15 @@ namespace toucan
     void anyToVec(const OTIO_NS::AnyVector&, IMATH_NAMESPACE::V2i&);
     void anyToVec(const OTIO_NS::AnyVector&, IMATH_NAMESPACE::V4f&);
 
+    //! Combine a value with a hash.
+    void hashCombine(std::size_t& hash, std::size_t value);
+
+    //! Get a hash for an any value.
+    std::size_t hashAny(const std::any&);
+
+    //! Get a hash for an any dictionary.
+    std::size_t hashAny(const OTIO_NS::AnyDictionary&);
+
     //! Get standard OpenFX plugin search paths.
     //! Includes executable directory, standard OS-specific plugin directories,
     //! and paths from the OFX_PLUGIN_PATH environment variable.
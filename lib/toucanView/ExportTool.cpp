@@ -365,10 +365,10 @@ namespace toucan
             return;
         try
         {
-            _graph = std::make_shared<ImageGraph>(
-                getContext(),
-                _file->getPath(),
-                _file->getTimelineWrapper());
+            // Share the image graph with the viewer, using a separate context
+            // so that exporting does not disturb playback.
+            _graph = _file->getImageGraph();
+            _graphContext = std::make_shared<ImageGraphContext>();
             _imageSize = _graph->getImageSize();
             _outputSize = _imageSize;
             if (_sizeComboBox->getCurrentIndex() != 0)
@@ -415,6 +415,7 @@ namespace toucan
                 {
                     _timer->stop();
                     _graph.reset();
+                    _graphContext.reset();
                     _ffWrite.reset();
                     _dialog.reset();
                 });
@@ -437,7 +438,7 @@ namespace toucan
 
     void ExportWidget::_exportFrame()
     {
-        if (auto node = _graph->exec(_host, _time))
+        if (auto node = _graph->exec(*_graphContext, _host, _time))
         {
             auto buf = node->exec();
             if (_outputSize != _imageSize)
@@ -86,6 +86,7 @@ namespace toucan
         OTIO_NS::TimeRange _timeRange;
         OTIO_NS::RationalTime _time;
         std::shared_ptr<ImageGraph> _graph;
+        std::shared_ptr<ImageGraphContext> _graphContext;
         IMATH_NAMESPACE::V2d _imageSize = IMATH_NAMESPACE::V2d(0, 0);
         IMATH_NAMESPACE::V2d _outputSize = IMATH_NAMESPACE::V2d(0, 0);
         std::vector<std::string> _movieCodecs;
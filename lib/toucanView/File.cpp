@@ -13,6 +13,11 @@
 
 namespace toucan
 {
+    namespace
+    {
+        const size_t readAheadFrames = 8;
+    }
+
     File::File(
         const std::shared_ptr<ftk::Context>& context,
         const std::shared_ptr<ImageEffectHost>& host,
@@ -41,6 +46,16 @@ namespace toucan
             path.parent_path(),
             _timelineWrapper);
 
+        _playbackObserver = ftk::ValueObserver<Playback>::create(
+            _playbackModel->observePlayback(),
+            [this](Playback value)
+            {
+                // Read ahead in the playback direction.
+                _graph->setReadAhead(
+                    readAheadFrames,
+                    Playback::Reverse == value ? -1 : 1);
+            });
+
         _currentTimeObserver = ftk::ValueObserver<OTIO_NS::RationalTime>::create(
             _playbackModel->observeCurrentTime(),
             [this](const OTIO_NS::RationalTime& value)
@@ -71,6 +86,11 @@ namespace toucan
         return _timelineWrapper->getTimeline();
     }
 
+    const std::shared_ptr<ImageGraph>& File::getImageGraph() const
+    {
+        return _graph;
+    }
+
     const std::shared_ptr<PlaybackModel>& File::getPlaybackModel() const
     {
         return _playbackModel;
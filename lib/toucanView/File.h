@@ -17,6 +17,7 @@ namespace toucan
 {
     class PlaybackModel;
     class SelectionModel;
+    enum class Playback;
     class ViewModel;
 
     //! Timeline file.
@@ -39,6 +40,10 @@ namespace toucan
         //! Get the timeline.
         const OTIO_NS::SerializableObject::Retainer<OTIO_NS::Timeline>& getTimeline() const;
 
+        //! Get the image graph. The graph can be shared with other users
+        //! of the file, each with their own evaluation context.
+        const std::shared_ptr<ImageGraph>& getImageGraph() const;
+
         //! Get the playback model.
         const std::shared_ptr<PlaybackModel>& getPlaybackModel() const;
 
@@ -87,5 +92,6 @@ namespace toucan
         OIIO::ImageBuf _imageBuf;
 
         std::shared_ptr<ftk::ValueObserver<OTIO_NS::RationalTime> > _currentTimeObserver;
+        std::shared_ptr<ftk::ValueObserver<Playback> > _playbackObserver;
     };
 }
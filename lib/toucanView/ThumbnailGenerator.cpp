@@ -35,17 +35,13 @@ namespace toucan
     ThumbnailGenerator::ThumbnailGenerator(
         const std::shared_ptr<ftk::Context>& context,
         const std::shared_ptr<ImageEffectHost>& host,
-        const std::shared_ptr<TimelineWrapper>& timelineWrapper) :
+        const std::shared_ptr<ImageGraph>& graph) :
         _host(host),
-        _timelineWrapper(timelineWrapper)
+        _graph(graph),
+        _graphContext(std::make_unique<ImageGraphContext>())
     {
         _logSystem = context->getSystem<ftk::LogSystem>();
 
-        _graph = std::make_shared<ImageGraph>(
-            context,
-            timelineWrapper->getPath().parent_path(),
-            timelineWrapper);
-
         _thread.running = true;
         _thread.thread = std::thread(
             [this]
@@ -187,7 +183,7 @@ namespace toucan
         if (aspectRequest)
         {
             float aspect = 1.F;
-            if (auto node = _graph->exec(_host, aspectRequest->time, aspectRequest->item))
+            if (auto node = _graph->exec(*_graphContext, _host, aspectRequest->time, aspectRequest->item))
             {
                 OIIO::ImageBuf buf = node->exec();
                 const auto& spec = buf.spec();
@@ -201,7 +197,7 @@ namespace toucan
         if (request)
         {
             OIIO::ImageBuf buf;
-            if (auto node = _graph->exec(_host, request->time, request->item))
+            if (auto node = _graph->exec(*_graphContext, _host, request->time, request->item))
             {
                 buf = node->exec();
             }
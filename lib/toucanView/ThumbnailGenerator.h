@@ -20,6 +20,7 @@ namespace toucan
     class IReadNode;
     class ImageEffectHost;
     class ImageGraph;
+    class ImageGraphContext;
     class TimelineWrapper;
 
     //! Get a thumbnail cache key.
@@ -44,7 +45,7 @@ namespace toucan
         ThumbnailGenerator(
             const std::shared_ptr<ftk::Context>&,
             const std::shared_ptr<ImageEffectHost>&,
-            const std::shared_ptr<TimelineWrapper>&);
+            const std::shared_ptr<ImageGraph>&);
 
         ~ThumbnailGenerator();
 
@@ -68,8 +69,8 @@ namespace toucan
 
         std::shared_ptr<ftk::LogSystem> _logSystem;
         std::shared_ptr<ImageEffectHost> _host;
-        std::shared_ptr<TimelineWrapper> _timelineWrapper;
         std::shared_ptr<ImageGraph> _graph;
+        std::unique_ptr<ImageGraphContext> _graphContext;
 
         struct AspectRequest
         {
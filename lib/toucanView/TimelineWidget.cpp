@@ -67,7 +67,7 @@ namespace toucan
                     _thumbnailGenerator = std::make_shared<ThumbnailGenerator>(
                         context,
                         app->getHost(),
-                        file->getTimelineWrapper());
+                        file->getImageGraph());
 
                     ItemData data;
                     data.app = app;
@@ -197,6 +197,20 @@ OfxStatus ColorConvertPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus ColorConvertPlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    std::string fromSpace;
+    std::string toSpace;
+    _paramSuite->paramGetValue(_fromSpaceParam[handle], &fromSpace);
+    _paramSuite->paramGetValue(_toSpaceParam[handle], &toSpace);
+    return !fromSpace.empty() && fromSpace == toSpace ?
+        _setIdentity(inArgs, outArgs, "Source") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus ColorConvertPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
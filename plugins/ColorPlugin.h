@@ -53,6 +53,10 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
@@ -28,6 +28,14 @@ OfxStatus DrawPlugin::_describeAction(OfxImageEffectHandle handle)
         0,
         kOfxImageEffectContextFilter);
 
+    // The shapes are drawn over the source image, so it can be rendered
+    // in place.
+    _propSuite->propSetInt(
+        effectProps,
+        kToucanImageEffectPropSupportsInPlace,
+        0,
+        1);
+
     return kOfxStatOK;
 }
 
@@ -211,7 +219,10 @@ OfxStatus BoxPlugin::_render(
     _paramSuite->paramGetValue(_colorParam[handle], &color[0], &color[1], &color[2], &color[3]);
     _paramSuite->paramGetValue(_fillParam[handle], &fill);
 
-    OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    if (outputBuf.localpixels() != sourceBuf.localpixels())
+    {
+        OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    }
     OIIO::ImageBufAlgo::render_box(
         outputBuf,
         pos1[0],
@@ -319,7 +330,10 @@ OfxStatus LinePlugin::_render(
     _paramSuite->paramGetValue(_colorParam[handle], &color[0], &color[1], &color[2], &color[3]);
     _paramSuite->paramGetValue(_skipFirstPointParam[handle], &skipFirstPoint);
 
-    OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    if (outputBuf.localpixels() != sourceBuf.localpixels())
+    {
+        OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    }
     OIIO::ImageBufAlgo::render_line(
         outputBuf,
         pos1[0],
@@ -433,7 +447,10 @@ OfxStatus TextPlugin::_render(
     _paramSuite->paramGetValue(_fontNameParam[handle], &fontName);
     _paramSuite->paramGetValue(_colorParam[handle], &color[0], &color[1], &color[2], &color[3]);
 
-    OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    if (outputBuf.localpixels() != sourceBuf.localpixels())
+    {
+        OIIO::ImageBufAlgo::copy(outputBuf, sourceBuf);
+    }
     OIIO::ImageBufAlgo::render_text(
         outputBuf,
         pos[0],
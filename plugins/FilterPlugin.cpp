@@ -7,6 +7,8 @@
 
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <cmath>
+
 FilterPlugin::FilterPlugin(const std::string& group, const std::string& name) :
     Plugin(group, name)
 {}
@@ -26,6 +28,19 @@ OfxStatus FilterPlugin::_describeAction(OfxImageEffectHandle handle)
         0,
         kOfxImageEffectContextFilter);
 
+    // Filters only write to the render window, so the host can render
+    // tiles of the output in parallel.
+    _propSuite->propSetString(
+        effectProps,
+        kOfxImageEffectPluginRenderThreadSafety,
+        0,
+        kOfxImageEffectRenderFullySafe);
+    _propSuite->propSetInt(
+        effectProps,
+        kOfxImageEffectPluginPropHostFrameThreading,
+        0,
+        1);
+
     return kOfxStatOK;
 }
 
@@ -121,6 +136,23 @@ OfxStatus FilterPlugin::_renderAction(
     return kOfxStatOK;
 }
 
+OfxStatus FilterPlugin::_setSourceRegionOfInterest(
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs,
+    double kernelSize)
+{
+    OfxRectD roi;
+    _propSuite->propGetDoubleN(inArgs, kOfxImageEffectPropRegionOfInterest, 4, &roi.x1);
+    const double margin = std::ceil(kernelSize / 2.0) + 1.0;
+    roi.x1 -= margin;
+    roi.y1 -= margin;
+    roi.x2 += margin;
+    roi.y2 += margin;
+    const std::string name = std::string(kOfxImageClipPropRoI) + "Source";
+    _propSuite->propSetDoubleN(outArgs, name.c_str(), 4, &roi.x1);
+    return kOfxStatOK;
+}
+
 BlurPlugin* BlurPlugin::_plugin = nullptr;
 
 BlurPlugin::BlurPlugin() :
@@ -175,6 +207,28 @@ OfxStatus BlurPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus BlurPlugin::_getRegionsOfInterestAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double radius = 0.0;
+    _paramSuite->paramGetValue(_radiusParam[handle], &radius);
+    return _setSourceRegionOfInterest(inArgs, outArgs, radius);
+}
+
+OfxStatus BlurPlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double radius = 0.0;
+    _paramSuite->paramGetValue(_radiusParam[handle], &radius);
+    return radius <= 0.0 ?
+        _setIdentity(inArgs, outArgs, "Source") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus BlurPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
@@ -324,6 +378,21 @@ OfxStatus InvertPlugin::mainEntryPoint(
     return _plugin->_entryPoint(action, handle, inArgs, outArgs);
 }
 
+OfxStatus InvertPlugin::_describeAction(OfxImageEffectHandle handle)
+{
+    FilterPlugin::_describeAction(handle);
+
+    OfxPropertySetHandle effectProps;
+    _effectSuite->getPropertySet(handle, &effectProps);
+    _propSuite->propSetInt(
+        effectProps,
+        kToucanImageEffectPropSupportsInPlace,
+        0,
+        1);
+
+    return kOfxStatOK;
+}
+
 OfxStatus InvertPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
@@ -345,20 +414,23 @@ OfxStatus InvertPlugin::_render(
             0,
             3));
 
-    // Copy the alpha channel.
-    OIIO::ImageBufAlgo::copy(
-        outputBuf,
-        sourceBuf,
-        OIIO::TypeUnknown,
-        OIIO::ROI(
-            renderWindow.x1,
-            renderWindow.x2,
-            renderWindow.y1,
-            renderWindow.y2,
-            0,
-            1,
-            3,
-            4));
+    // Copy the alpha channel, unless rendering in place.
+    if (outputBuf.localpixels() != sourceBuf.localpixels())
+    {
+        OIIO::ImageBufAlgo::copy(
+            outputBuf,
+            sourceBuf,
+            OIIO::TypeUnknown,
+            OIIO::ROI(
+                renderWindow.x1,
+                renderWindow.x2,
+                renderWindow.y1,
+                renderWindow.y2,
+                0,
+                1,
+                3,
+                4));
+    }
 
     return kOfxStatOK;
 }
@@ -390,6 +462,21 @@ OfxStatus PowPlugin::mainEntryPoint(
     return _plugin->_entryPoint(action, handle, inArgs, outArgs);
 }
 
+OfxStatus PowPlugin::_describeAction(OfxImageEffectHandle handle)
+{
+    FilterPlugin::_describeAction(handle);
+
+    OfxPropertySetHandle effectProps;
+    _effectSuite->getPropertySet(handle, &effectProps);
+    _propSuite->propSetInt(
+        effectProps,
+        kToucanImageEffectPropSupportsInPlace,
+        0,
+        1);
+
+    return kOfxStatOK;
+}
+
 OfxStatus PowPlugin::_describeInContextAction(
     OfxImageEffectHandle handle,
     OfxPropertySetHandle inArgs)
@@ -417,6 +504,18 @@ OfxStatus PowPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus PowPlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double value = 1.0;
+    _paramSuite->paramGetValue(_valueParam[handle], &value);
+    return 1.0 == value ?
+        _setIdentity(inArgs, outArgs, "Source") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus PowPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
@@ -467,6 +566,21 @@ OfxStatus SaturatePlugin::mainEntryPoint(
     return _plugin->_entryPoint(action, handle, inArgs, outArgs);
 }
 
+OfxStatus SaturatePlugin::_describeAction(OfxImageEffectHandle handle)
+{
+    FilterPlugin::_describeAction(handle);
+
+    OfxPropertySetHandle effectProps;
+    _effectSuite->getPropertySet(handle, &effectProps);
+    _propSuite->propSetInt(
+        effectProps,
+        kToucanImageEffectPropSupportsInPlace,
+        0,
+        1);
+
+    return kOfxStatOK;
+}
+
 OfxStatus SaturatePlugin::_describeInContextAction(
     OfxImageEffectHandle handle,
     OfxPropertySetHandle inArgs)
@@ -494,6 +608,18 @@ OfxStatus SaturatePlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus SaturatePlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double value = 1.0;
+    _paramSuite->paramGetValue(_valueParam[handle], &value);
+    return 1.0 == value ?
+        _setIdentity(inArgs, outArgs, "Source") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus SaturatePlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
@@ -587,6 +713,16 @@ OfxStatus UnsharpMaskPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus UnsharpMaskPlugin::_getRegionsOfInterestAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double width = 3.0;
+    _paramSuite->paramGetValue(_widthParam[handle], &width);
+    return _setSourceRegionOfInterest(inArgs, outArgs, width);
+}
+
 OfxStatus UnsharpMaskPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
@@ -22,6 +22,13 @@ protected:
         const OfxRectI& renderWindow,
         OfxPropertySetHandle inArgs) = 0;
 
+    //! Set the source region of interest to the given region expanded by
+    //! the kernel size.
+    OfxStatus _setSourceRegionOfInterest(
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs,
+        double kernelSize);
+
     OfxStatus _describeAction(OfxImageEffectHandle) override;
     OfxStatus _describeInContextAction(
         OfxImageEffectHandle,
@@ -52,6 +59,14 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _getRegionsOfInterestAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
+    OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
@@ -112,6 +127,7 @@ public:
         OfxPropertySetHandle outArgs);
 
 protected:
+    OfxStatus _describeAction(OfxImageEffectHandle) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
@@ -139,10 +155,15 @@ public:
         OfxPropertySetHandle outArgs);
 
 protected:
+    OfxStatus _describeAction(OfxImageEffectHandle) override;
     OfxStatus _describeInContextAction(
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
@@ -171,10 +192,15 @@ public:
         OfxPropertySetHandle outArgs);
 
 protected:
+    OfxStatus _describeAction(OfxImageEffectHandle) override;
     OfxStatus _describeInContextAction(
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
@@ -207,6 +233,10 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _getRegionsOfInterestAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         const OIIO::ImageBuf&,
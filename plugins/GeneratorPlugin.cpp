@@ -189,6 +189,23 @@ OfxStatus CheckersPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus CheckersPlugin::_getClipPreferencesAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double color1[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double color2[4] = { 0.0, 0.0, 0.0, 0.0 };
+    _paramSuite->paramGetValue(_color1Param[handle], &color1[0], &color1[1], &color1[2], &color1[3]);
+    _paramSuite->paramGetValue(_color2Param[handle], &color2[0], &color2[1], &color2[2], &color2[3]);
+    if (color1[3] >= 1.0 && color2[3] >= 1.0)
+    {
+        _propSuite->propSetString(outArgs, kOfxImageEffectPropPreMultiplication, 0, kOfxImageOpaque);
+        return kOfxStatOK;
+    }
+    return kOfxStatReplyDefault;
+}
+
 OfxStatus CheckersPlugin::_render(
     OfxImageEffectHandle handle,
     OIIO::ImageBuf& outputBuf,
@@ -280,6 +297,26 @@ OfxStatus FillPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus FillPlugin::_getClipPreferencesAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double color[4] = { 0.0, 0.0, 0.0, 0.0 };
+    _paramSuite->paramGetValue(
+        _colorParam[handle],
+        &color[0],
+        &color[1],
+        &color[2],
+        &color[3]);
+    if (color[3] >= 1.0)
+    {
+        _propSuite->propSetString(outArgs, kOfxImageEffectPropPreMultiplication, 0, kOfxImageOpaque);
+        return kOfxStatOK;
+    }
+    return kOfxStatReplyDefault;
+}
+
 OfxStatus FillPlugin::_render(
     OfxImageEffectHandle handle,
     OIIO::ImageBuf& outputBuf,
@@ -375,6 +412,23 @@ OfxStatus GradientPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus GradientPlugin::_getClipPreferencesAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    double color1[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double color2[4] = { 0.0, 0.0, 0.0, 0.0 };
+    _paramSuite->paramGetValue(_color1Param[handle], &color1[0], &color1[1], &color1[2], &color1[3]);
+    _paramSuite->paramGetValue(_color2Param[handle], &color2[0], &color2[1], &color2[2], &color2[3]);
+    if (color1[3] >= 1.0 && color2[3] >= 1.0)
+    {
+        _propSuite->propSetString(outArgs, kOfxImageEffectPropPreMultiplication, 0, kOfxImageOpaque);
+        return kOfxStatOK;
+    }
+    return kOfxStatReplyDefault;
+}
+
 OfxStatus GradientPlugin::_render(
     OfxImageEffectHandle handle,
     OIIO::ImageBuf& outputBuf,
@@ -55,6 +55,10 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _getClipPreferencesAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         OIIO::ImageBuf&,
@@ -88,6 +92,10 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _getClipPreferencesAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         OIIO::ImageBuf&,
@@ -119,6 +127,10 @@ protected:
         OfxImageEffectHandle,
         OfxPropertySetHandle) override;
     OfxStatus _createInstance(OfxImageEffectHandle) override;
+    OfxStatus _getClipPreferencesAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         OfxImageEffectHandle,
         OIIO::ImageBuf&,
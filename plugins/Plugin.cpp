@@ -47,6 +47,18 @@ OfxStatus Plugin::_entryPoint(
     {
         out = _destroyInstance(effectHandle);
     }
+    else if (strcmp(action, kOfxImageEffectActionGetRegionsOfInterest) == 0)
+    {
+        out = _getRegionsOfInterestAction(effectHandle, inArgs, outArgs);
+    }
+    else if (strcmp(action, kOfxImageEffectActionGetClipPreferences) == 0)
+    {
+        out = _getClipPreferencesAction(effectHandle, inArgs, outArgs);
+    }
+    else if (strcmp(action, kOfxImageEffectActionIsIdentity) == 0)
+    {
+        out = _isIdentityAction(effectHandle, inArgs, outArgs);
+    }
     else if (strcmp(action, kOfxImageEffectActionRender) == 0)
     {
         out = _renderAction(effectHandle, inArgs, outArgs);
@@ -108,6 +120,30 @@ OfxStatus Plugin::_destroyInstance(OfxImageEffectHandle)
     return kOfxStatOK;
 }
 
+OfxStatus Plugin::_getRegionsOfInterestAction(
+    OfxImageEffectHandle,
+    OfxPropertySetHandle,
+    OfxPropertySetHandle)
+{
+    return kOfxStatReplyDefault;
+}
+
+OfxStatus Plugin::_getClipPreferencesAction(
+    OfxImageEffectHandle,
+    OfxPropertySetHandle,
+    OfxPropertySetHandle)
+{
+    return kOfxStatReplyDefault;
+}
+
+OfxStatus Plugin::_isIdentityAction(
+    OfxImageEffectHandle,
+    OfxPropertySetHandle,
+    OfxPropertySetHandle)
+{
+    return kOfxStatReplyDefault;
+}
+
 OfxStatus Plugin::_renderAction(
     OfxImageEffectHandle instance,
     OfxPropertySetHandle inArgs,
@@ -115,3 +151,15 @@ OfxStatus Plugin::_renderAction(
 {
     return kOfxStatOK;
 }
+
+OfxStatus Plugin::_setIdentity(
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs,
+    const std::string& clip)
+{
+    OfxTime time = 0.0;
+    _propSuite->propGetDouble(inArgs, kOfxPropTime, 0, &time);
+    _propSuite->propSetString(outArgs, kOfxPropName, 0, clip.c_str());
+    _propSuite->propSetDouble(outArgs, kOfxPropTime, 0, time);
+    return kOfxStatOK;
+}
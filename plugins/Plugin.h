@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <toucanRender/ImageEffectExtensions.h>
+
 #include <OpenFX/ofxImageEffect.h>
 #include <OpenFX/ofxParam.h>
 
@@ -29,11 +31,29 @@ protected:
         OfxPropertySetHandle);
     virtual OfxStatus _createInstance(OfxImageEffectHandle);
     virtual OfxStatus _destroyInstance(OfxImageEffectHandle);
+    virtual OfxStatus _getRegionsOfInterestAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs);
+    virtual OfxStatus _getClipPreferencesAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs);
+    virtual OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs);
     virtual OfxStatus _renderAction(
         OfxImageEffectHandle,
         OfxPropertySetHandle inArgs,
         OfxPropertySetHandle outArgs);
 
+    //! Reply to the identity action with the clip that is passed through.
+    OfxStatus _setIdentity(
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs,
+        const std::string& clip);
+
     std::string _name;
     std::string _group;
     OfxHost* _host = nullptr;
@@ -28,6 +28,13 @@ OfxStatus TransformPlugin::_describeAction(OfxImageEffectHandle handle)
         0,
         kOfxImageEffectContextFilter);
 
+    // Transforms need the whole source image.
+    _propSuite->propSetInt(
+        effectProps,
+        kOfxImageEffectPropSupportsTiles,
+        0,
+        0);
+
     return kOfxStatOK;
 }
 
@@ -182,6 +189,37 @@ OfxStatus CropPlugin::_createInstance(OfxImageEffectHandle handle)
     return kOfxStatOK;
 }
 
+OfxStatus CropPlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    int64_t pos[2] = { 0, 0 };
+    int64_t size[2] = { 0, 0 };
+    _paramSuite->paramGetValue(_posParam[handle], &pos[0], &pos[1]);
+    _paramSuite->paramGetValue(_sizeParam[handle], &size[0], &size[1]);
+
+    // The crop is an identity if it covers the whole source image.
+    OfxImageClipHandle sourceClip;
+    _effectSuite->clipGetHandle(handle, "Source", &sourceClip, nullptr);
+    OfxTime time = 0.0;
+    _propSuite->propGetDouble(inArgs, kOfxPropTime, 0, &time);
+    OfxRectD sourceROD = { 0.0, 0.0, 0.0, 0.0 };
+    if (kOfxStatOK != _effectSuite->clipGetRegionOfDefinition(sourceClip, time, &sourceROD))
+    {
+        return kOfxStatReplyDefault;
+    }
+    return
+        0 == pos[0] &&
+        0 == pos[1] &&
+        size[0] > 0 &&
+        size[1] > 0 &&
+        sourceROD.x2 - sourceROD.x1 == size[0] &&
+        sourceROD.y2 - sourceROD.y1 == size[1] ?
+        _setIdentity(inArgs, outArgs, "Source") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus CropPlugin::_render(
     OfxImageEffectHandle handle,
     const OIIO::ImageBuf& sourceBuf,
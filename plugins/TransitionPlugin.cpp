@@ -189,6 +189,20 @@ OfxStatus DissolvePlugin::mainEntryPoint(
     return _plugin->_entryPoint(action, handle, inArgs, outArgs);
 }
 
+OfxStatus DissolvePlugin::_isIdentityAction(
+    OfxImageEffectHandle handle,
+    OfxPropertySetHandle inArgs,
+    OfxPropertySetHandle outArgs)
+{
+    // The start of the dissolve is an identity. The end is not, since the
+    // second source is fit to the size of the first.
+    double value = 0.0;
+    _paramSuite->paramGetValue(_valueParam[handle], &value);
+    return value <= 0.0 ?
+        _setIdentity(inArgs, outArgs, "SourceFrom") :
+        kOfxStatReplyDefault;
+}
+
 OfxStatus DissolvePlugin::_render(
     const OIIO::ImageBuf& sourceFromBuf,
     const OIIO::ImageBuf& sourceToBuf,
@@ -239,29 +253,20 @@ OfxStatus DissolvePlugin::_render(
         sourceToBufP = &tmpBuf;
     }
 
+    // Blend directly into the output image, without temporary images.
     const float v = value;
     const float iv = 1.0 - value;
-
-    OIIO::ImageBuf sourceFromFillBuf(sourceFromSpec);
-    OIIO::ImageBufAlgo::fill(
-        sourceFromFillBuf,
-        { iv, iv, iv, iv },
+    OIIO::ImageBufAlgo::mul(
+        outputBuf,
+        sourceFromBuf,
+        iv,
         sourceFromBuf.roi());
-
-    OIIO::ImageBuf sourceToFillBuf(sourceToBufP->spec());
-    OIIO::ImageBufAlgo::fill(
-        sourceToFillBuf,
-        { v, v, v, v },
-        sourceToBufP->roi());
-
-    OIIO::ImageBufAlgo::add(
+    OIIO::ImageBufAlgo::mad(
         outputBuf,
-        OIIO::ImageBufAlgo::mul(
-            sourceFromBuf,
-            sourceFromFillBuf, sourceFromBuf.roi()),
-        OIIO::ImageBufAlgo::mul(
-            *sourceToBufP,
-            sourceToFillBuf, sourceToBufP->roi()));
+        *sourceToBufP,
+        v,
+        outputBuf,
+        sourceToBufP->roi());
 
     return kOfxStatOK;
 }
@@ -52,6 +52,10 @@ public:
         OfxPropertySetHandle outArgs);
 
 protected:
+    OfxStatus _isIdentityAction(
+        OfxImageEffectHandle,
+        OfxPropertySetHandle inArgs,
+        OfxPropertySetHandle outArgs) override;
     OfxStatus _render(
         const OIIO::ImageBuf&,
         const OIIO::ImageBuf&,
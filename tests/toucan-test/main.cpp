@@ -10,7 +10,14 @@
 #endif // toucan_VIEW
 
 #include <toucanRenderTest/CompTest.h>
+#include <toucanRenderTest/ConstantTest.h>
+#include <toucanRenderTest/ImageArenaTest.h>
+#include <toucanRenderTest/ImageCacheTest.h>
 #include <toucanRenderTest/ImageGraphTest.h>
+#include <toucanRenderTest/ImageNodeTest.h>
+#include <toucanRenderTest/ImagePlanTest.h>
+#include <toucanRenderTest/MediaPoolTest.h>
+#include <toucanRenderTest/MemoryMapTest.h>
 #include <toucanRenderTest/PropertySetTest.h>
 #include <toucanRenderTest/ReadTest.h>
 
@@ -42,6 +49,13 @@ int main(int argc, char** argv)
     auto host = std::make_shared<ImageEffectHost>(context, getOpenFXPluginPaths(argv[0]));
 
     compTest(path);
+    constantTest(path);
+    imageArenaTest(path);
+    imageCacheTest(path);
+    imageNodeTest();
+    imagePlanTest();
+    mediaPoolTest(path);
+    memoryMapTest();
     propertySetTest();
     readTest(path);
     imageGraphTest(context, host, path);
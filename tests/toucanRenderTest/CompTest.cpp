@@ -6,6 +6,10 @@
 #include <toucanRender/Read.h>
 #include <toucanRender/Comp.h>
 
+#include <OpenImageIO/imagebufalgo.h>
+
+#include <cassert>
+
 namespace toucan
 {
     void compTest(const std::filesystem::path& path)
@@ -18,5 +22,61 @@ namespace toucan
         comp->setPremult(true);
         auto buf = comp->exec();
         buf.write("compTest.png");
+
+        // Compare the compositing kernel with OpenImageIO.
+        for (const auto fgFormat : {
+            OIIO::TypeDesc::UINT8,
+            OIIO::TypeDesc::UINT16,
+            OIIO::TypeDesc::HALF,
+            OIIO::TypeDesc::FLOAT })
+        {
+            for (const auto bgFormat : {
+                OIIO::TypeDesc::UINT8,
+                OIIO::TypeDesc::UINT16,
+                OIIO::TypeDesc::HALF,
+                OIIO::TypeDesc::FLOAT })
+            {
+                for (const bool premult : { false, true })
+                {
+                    OIIO::ImageBuf fgBuf(OIIO::ImageSpec(64, 32, 4, fgFormat));
+                    const float fgStart[] = { 1.F, 0.5F, 0.F, 0.F };
+                    const float fgEnd[] = { 0.F, 0.5F, 1.F, 1.F };
+                    OIIO::ImageBufAlgo::fill(fgBuf, fgStart, fgEnd);
+                    OIIO::ImageBuf bgBuf(OIIO::ImageSpec(64, 32, 4, bgFormat));
+                    const float bgColor[] = { 0.25F, 0.75F, 0.5F, 1.F };
+                    OIIO::ImageBufAlgo::fill(bgBuf, bgColor);
+
+                    OIIO::ImageBuf expected;
+                    if (premult)
+                    {
+                        OIIO::ImageBuf tmp = OIIO::ImageBufAlgo::premult(fgBuf);
+                        expected = OIIO::ImageBufAlgo::over(tmp, bgBuf);
+                    }
+                    else
+                    {
+                        expected = OIIO::ImageBufAlgo::over(fgBuf, bgBuf);
+                    }
+                    const bool supported = compOver(bgBuf, fgBuf, premult);
+                    assert(supported);
+                    const float threshold =
+                        OIIO::TypeDesc::UINT8 == fgFormat || OIIO::TypeDesc::UINT8 == bgFormat ?
+                        2.F / 255.F :
+                        1.F / 512.F;
+                    const auto result = OIIO::ImageBufAlgo::compare(
+                        bgBuf,
+                        expected,
+                        threshold,
+                        threshold);
+                    assert(0 == result.nfail);
+                }
+            }
+        }
+        {
+            // Images without an alpha channel are not supported.
+            OIIO::ImageBuf fgBuf(OIIO::ImageSpec(16, 16, 3, OIIO::TypeDesc::UINT8));
+            OIIO::ImageBuf bgBuf(OIIO::ImageSpec(16, 16, 4, OIIO::TypeDesc::UINT8));
+            const bool supported = compOver(bgBuf, fgBuf, false);
+            assert(!supported);
+        }
     }
 }
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ConstantTest.h"
+
+#include <toucanRender/Comp.h>
+#include <toucanRender/Constant.h>
+#include <toucanRender/ImagePlan.h>
+#include <toucanRender/Read.h>
+
+#include <OpenImageIO/imagebufalgo.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace toucan
+{
+    void constantTest(const std::filesystem::path& path)
+    {
+        std::cout << "constantTest" << std::endl;
+        {
+            auto constant = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 8),
+                IMATH_NAMESPACE::V4f(1.F, 0.5F, 0.25F, 1.F));
+            assert(constant->isOpaque());
+            assert(!constant->isTransparent());
+            assert(16 == constant->getRegionOfDefinition().width());
+            const auto buf = constant->exec();
+            assert(16 == buf.spec().width);
+            assert(8 == buf.spec().height);
+            float pixel[4] = { 0.F, 0.F, 0.F, 0.F };
+            buf.getpixel(3, 3, pixel);
+            assert(1.F == pixel[0]);
+            assert(0.5F == pixel[1]);
+            assert(0.25F == pixel[2]);
+            assert(1.F == pixel[3]);
+
+            constant->setColor(IMATH_NAMESPACE::V4f(0.F, 0.F, 0.F, 0.F));
+            assert(constant->isTransparent());
+            assert(!constant->isOpaque());
+        }
+        {
+            // Compositing over a constant color gives the same result as
+            // compositing over the filled image.
+            auto fg = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            const auto roi = fg->getRegionOfDefinition();
+            const IMATH_NAMESPACE::V4f color(0.F, 0.F, 0.F, 1.F);
+            auto constant = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(roi.width(), roi.height()),
+                color);
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, constant });
+            comp->setPremult(true);
+            ImagePlan plan(comp);
+            assert(2 == plan.getSteps().size());
+            const auto buf = comp->exec();
+
+            const auto fgBuf = fg->exec();
+            OIIO::ImageBuf bgBuf(OIIO::ImageSpec(roi.width(), roi.height(), 4));
+            const float values[] = { color.x, color.y, color.z, color.w };
+            OIIO::ImageBufAlgo::fill(bgBuf, values);
+            const auto expected = OIIO::ImageBufAlgo::over(
+                OIIO::ImageBufAlgo::premult(fgBuf),
+                bgBuf);
+            const auto result = OIIO::ImageBufAlgo::compare(
+                buf,
+                expected,
+                1.F / 255.F,
+                1.F / 255.F);
+            assert(0 == result.nfail);
+        }
+        {
+            // Compositing a transparent constant does not change the
+            // background.
+            auto bg = std::make_shared<ImageReadNode>(path / "Gradient.png");
+            const auto roi = bg->getRegionOfDefinition();
+            auto constant = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(roi.width(), roi.height()));
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ constant, bg });
+            ImagePlan plan(comp);
+            assert(2 == plan.getSteps().size());
+            const auto buf = comp->exec();
+            const auto result = OIIO::ImageBufAlgo::compare(
+                buf,
+                bg->exec(),
+                0.F,
+                0.F);
+            assert(0 == result.nfail);
+        }
+        {
+            // Composite over a color in place.
+            OIIO::ImageBuf fgBuf(OIIO::ImageSpec(8, 8, 4, OIIO::TypeDesc::FLOAT));
+            const float values[] = { 1.F, 1.F, 1.F, 0.5F };
+            OIIO::ImageBufAlgo::fill(fgBuf, values);
+            const bool supported = compOverColor(
+                fgBuf,
+                fgBuf,
+                IMATH_NAMESPACE::V4f(0.F, 0.F, 1.F, 1.F),
+                true);
+            assert(supported);
+            float pixel[4] = { 0.F, 0.F, 0.F, 0.F };
+            fgBuf.getpixel(0, 0, pixel);
+            assert(0.5F == pixel[0]);
+            assert(0.5F == pixel[1]);
+            assert(1.F == pixel[2]);
+            assert(1.F == pixel[3]);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImageArenaTest.h"
+
+#include <toucanRender/Comp.h>
+#include <toucanRender/ImageArena.h>
+#include <toucanRender/Read.h>
+
+#include <OpenImageIO/imagebufalgo.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace toucan
+{
+    void imageArenaTest(const std::filesystem::path& path)
+    {
+        std::cout << "imageArenaTest" << std::endl;
+        {
+            auto pool = std::make_shared<ImageMemoryPool>();
+            const OIIO::ImageSpec spec(64, 64, 4, OIIO::TypeDesc::UINT8);
+            const void* data = nullptr;
+            {
+                ImageArena arena(pool);
+                auto buf = arena.allocate(spec);
+                assert(arena.owns(buf));
+                assert(64 == buf.spec().width);
+                data = buf.localpixels();
+                const auto pixels = static_cast<const unsigned char*>(data);
+                for (size_t i = 0; i < spec.image_bytes(); ++i)
+                {
+                    assert(0 == pixels[i]);
+                }
+                OIIO::ImageBuf other(spec);
+                assert(!arena.owns(other));
+            }
+            auto stats = pool->getStats();
+            assert(0 == stats.hits);
+            assert(1 == stats.misses);
+            assert(stats.size >= spec.image_bytes());
+
+            // The memory is re-used by the next arena.
+            {
+                ImageArena arena(pool);
+                auto buf = arena.allocate(spec, OIIO::InitializePixels::No);
+                assert(buf.localpixels() == data);
+            }
+            stats = pool->getStats();
+            assert(1 == stats.hits);
+
+            // Released memory is returned to the pool before the arena
+            // is destroyed.
+            {
+                ImageArena arena(pool);
+                auto buf = arena.allocate(spec, OIIO::InitializePixels::No);
+                const size_t size = pool->getStats().size;
+                arena.release(buf);
+                assert(!arena.owns(buf));
+                assert(pool->getStats().size > size);
+                auto buf2 = arena.allocate(spec, OIIO::InitializePixels::No);
+                assert(buf2.localpixels() == buf.localpixels());
+                arena.release(OIIO::ImageBuf(spec));
+                assert(arena.owns(buf2));
+            }
+            stats = pool->getStats();
+            assert(3 == stats.hits);
+
+            // Adopted blocks are returned to the pool with the arena.
+            {
+                ImageArena arena(pool);
+                ImageMemoryBlock block = pool->acquire(spec.image_bytes());
+                data = block.data.get();
+                auto buf = arena.adopt(std::move(block), spec);
+                assert(arena.owns(buf));
+                assert(buf.localpixels() == data);
+            }
+            stats = pool->getStats();
+            assert(4 == stats.hits);
+            {
+                ImageArena arena(pool);
+                auto buf = arena.allocate(spec, OIIO::InitializePixels::No);
+                assert(buf.localpixels() == data);
+            }
+
+            // Idle memory is limited.
+            pool->setMax(0);
+            assert(0 == pool->getStats().size);
+        }
+        {
+            // Intermediate images are allocated from the arena, and the
+            // image returned to the caller has its own memory.
+            auto fg = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            auto bg = std::make_shared<ImageReadNode>(path / "Gradient.png");
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            const auto buf = comp->exec();
+            const auto buf2 = comp->exec();
+            assert(buf.spec().width > 0);
+            assert(OIIO::ImageBuf::LOCALBUFFER == buf.storage());
+            assert(0 == OIIO::ImageBufAlgo::compare(buf, buf2, 0.F, 0.F).nfail);
+            auto single = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg });
+            const auto buf3 = single->exec();
+            assert(OIIO::ImageBuf::LOCALBUFFER == buf3.storage());
+        }
+    }
+}
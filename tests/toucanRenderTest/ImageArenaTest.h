@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#pragma once
+
+#include <filesystem>
+
+namespace toucan
+{
+    void imageArenaTest(const std::filesystem::path&);
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImageCacheTest.h"
+
+#include <toucanRender/Comp.h>
+#include <toucanRender/ImageCache.h>
+#include <toucanRender/Read.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace toucan
+{
+    void imageCacheTest(const std::filesystem::path& path)
+    {
+        std::cout << "imageCacheTest" << std::endl;
+        {
+            auto fg = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            auto bg = std::make_shared<ImageReadNode>(path / "Gradient.png");
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            auto fg2 = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            auto bg2 = std::make_shared<ImageReadNode>(path / "Gradient.png");
+            auto comp2 = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg2, bg2 });
+            assert(comp->getHash() == comp2->getHash());
+            comp2->setPremult(true);
+            assert(comp->getHash() != comp2->getHash());
+            auto comp3 = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ bg, fg });
+            assert(comp->getHash() != comp3->getHash());
+        }
+        {
+            auto cache = std::make_shared<ImageCache>();
+            auto fg = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            auto bg = std::make_shared<ImageReadNode>(path / "Gradient.png");
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            comp->setImageCache(cache);
+            assert(0 == cache->getSize());
+            const auto buf = comp->exec();
+            assert(buf.spec().image_bytes() == cache->getSize());
+            OIIO::ImageBuf buf2;
+            assert(cache->get(comp->getHash(), buf2));
+            assert(buf.spec().width == buf2.spec().width);
+            assert(buf.spec().height == buf2.spec().height);
+            cache->setMax(0);
+            cache->clear();
+            comp->exec();
+            assert(0 == cache->getSize());
+        }
+    }
+}
@@ -3,11 +3,17 @@
 
 #include "ImageGraphTest.h"
 
+#include <toucanRender/Constant.h>
 #include <toucanRender/ImageGraph.h>
+#include <toucanRender/ImagePlan.h>
 #include <toucanRender/TimelineWrapper.h>
 #include <toucanRender/Util.h>
 
+#include <OpenImageIO/imagebufalgo.h>
+
+#include <cassert>
 #include <sstream>
+#include <thread>
 
 namespace toucan
 {
@@ -64,6 +70,12 @@ namespace toucan
                     // Execute the image graph.
                     const auto buf = node->exec();
 
+                    // The predicted memory covers the image, including
+                    // the floating point images of the effects.
+                    const ImagePlan plan(node, graph->getImageSpec());
+                    assert(plan.getSteps().back().bytes >= buf.spec().image_bytes());
+                    assert(plan.getPeakMemory() >= buf.spec().image_bytes());
+
                     // Save the image.
                     const std::string fileName = getSequenceFrame(
                         std::string(),
@@ -75,5 +87,137 @@ namespace toucan
                 }
             }
         }
+        {
+            // Test that the nodes are re-used within an edit segment.
+            auto timelineWrapper = std::make_shared<TimelineWrapper>(path / "Gap.otio");
+            const OTIO_NS::TimeRange& timeRange = timelineWrapper->getTimeRange();
+            const double rate = timeRange.duration().rate();
+            const auto graph = std::make_shared<ImageGraph>(context, path, timelineWrapper);
+            const auto node0 = graph->exec(host, timeRange.start_time());
+            const auto node1 = graph->exec(host, timeRange.start_time() + OTIO_NS::RationalTime(1.0, rate));
+            assert(node0 == node1);
+            const auto node3 = graph->exec(host, timeRange.start_time() + OTIO_NS::RationalTime(3.0, rate));
+            assert(node0 != node3);
+        }
+        {
+            // Test executing a graph concurrently with separate contexts.
+            auto timelineWrapper = std::make_shared<TimelineWrapper>(path / "Transition.otio");
+            const OTIO_NS::TimeRange& timeRange = timelineWrapper->getTimeRange();
+            const OTIO_NS::RationalTime timeInc(1.0, timeRange.duration().rate());
+            const auto graph = std::make_shared<ImageGraph>(context, path, timelineWrapper);
+            graph->setImageCache(nullptr);
+            std::vector<OTIO_NS::RationalTime> times;
+            std::vector<OIIO::ImageBuf> bufs;
+            for (OTIO_NS::RationalTime time = timeRange.start_time();
+                time <= timeRange.end_time_inclusive();
+                time += timeInc)
+            {
+                times.push_back(time);
+                bufs.push_back(graph->exec(host, time)->exec());
+            }
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 2; ++i)
+            {
+                threads.push_back(std::thread(
+                    [graph, host, &times, &bufs]
+                    {
+                        ImageGraphContext graphContext;
+                        for (size_t j = 0; j < times.size(); ++j)
+                        {
+                            const auto buf = graph->exec(graphContext, host, times[j])->exec();
+                            assert(0 == OIIO::ImageBufAlgo::compare(buf, bufs[j], 0.F, 0.F).nfail);
+                        }
+                    }));
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+        {
+            // Test that effects which do nothing pass their input through.
+            const auto from = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 16),
+                IMATH_NAMESPACE::V4f(.5F, .25F, .125F, 1.F));
+            const auto to = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 16),
+                IMATH_NAMESPACE::V4f(1.F, 1.F, 1.F, 1.F));
+            const auto fromBuf = from->exec();
+            OTIO_NS::AnyDictionary metaData;
+            metaData["radius"] = 0.0;
+            if (auto node = host->createNode(metaData, "toucan:Blur", { from }))
+            {
+                const auto buf = node->exec();
+                assert(0 == OIIO::ImageBufAlgo::compare(buf, fromBuf, 0.F, 0.F).nfail);
+            }
+            metaData.clear();
+            metaData["value"] = 1.0;
+            if (auto node = host->createNode(metaData, "toucan:Saturate", { from }))
+            {
+                const auto buf = node->exec();
+                assert(0 == OIIO::ImageBufAlgo::compare(buf, fromBuf, 0.F, 0.F).nfail);
+            }
+            metaData.clear();
+            metaData["value"] = 0.0;
+            if (auto node = host->createNode(metaData, "toucan:Dissolve", { from, to }))
+            {
+                const auto buf = node->exec();
+                assert(0 == OIIO::ImageBufAlgo::compare(buf, fromBuf, 0.F, 0.F).nfail);
+            }
+            metaData["value"] = 0.5;
+            if (auto node = host->createNode(metaData, "toucan:Dissolve", { from, to }))
+            {
+                const auto buf = node->exec();
+                assert(OIIO::ImageBufAlgo::compare(buf, fromBuf, 0.F, 0.F).nfail > 0);
+            }
+        }
+        {
+            // Test that rendering in place does not modify images that are
+            // used by other nodes.
+            const auto from = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 16),
+                IMATH_NAMESPACE::V4f(.25F, .5F, .75F, 1.F));
+            OTIO_NS::AnyDictionary metaData;
+            if (auto invert = host->createNode(metaData, "toucan:Invert", { from }))
+            {
+                const auto buf = invert->exec();
+                const auto stats = OIIO::ImageBufAlgo::computePixelStats(buf);
+                assert(.75F == stats.avg[0]);
+                assert(.5F == stats.avg[1]);
+                assert(.25F == stats.avg[2]);
+                assert(1.F == stats.avg[3]);
+
+                metaData["value"] = .5;
+                if (auto dissolve = host->createNode(metaData, "toucan:Dissolve", { from, invert }))
+                {
+                    const auto buf = dissolve->exec();
+                    const auto stats = OIIO::ImageBufAlgo::computePixelStats(buf);
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        assert(.5F == stats.avg[c]);
+                    }
+                    assert(1.F == stats.avg[3]);
+                }
+            }
+        }
+        {
+            // Test that pooled plugin instances use the new parameters.
+            const auto from = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 16),
+                IMATH_NAMESPACE::V4f(.25F, .25F, .25F, 1.F));
+            OTIO_NS::AnyDictionary metaData;
+            metaData["value"] = 2.0;
+            if (auto node = host->createNode(metaData, "toucan:Pow", { from }))
+            {
+                const auto stats = OIIO::ImageBufAlgo::computePixelStats(node->exec());
+                assert(.0625F == stats.avg[0]);
+            }
+            metaData["value"] = .5;
+            if (auto node = host->createNode(metaData, "toucan:Pow", { from }))
+            {
+                const auto stats = OIIO::ImageBufAlgo::computePixelStats(node->exec());
+                assert(.5F == stats.avg[0]);
+            }
+        }
     }
 }
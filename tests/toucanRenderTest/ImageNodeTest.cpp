@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImageNodeTest.h"
+
+#include <toucanRender/Comp.h>
+#include <toucanRender/ImagePlan.h>
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+
+namespace toucan
+{
+    namespace
+    {
+        class CountNode : public IImageNode
+        {
+        public:
+            CountNode() :
+                IImageNode("CountNode")
+            {}
+
+            int count = 0;
+            int evalCount = 0;
+            bool eval = false;
+            OIIO::ROI roi;
+            bool opaque = false;
+
+            OIIO::ROI getRegionOfDefinition() const override
+            {
+                return OIIO::ROI(0, 16, 0, 16);
+            }
+
+            bool isOpaque() const override
+            {
+                return opaque;
+            }
+
+        protected:
+            OIIO::ImageBuf _exec() override
+            {
+                ++count;
+                roi = _roi;
+                if (!eval)
+                {
+                    throw std::runtime_error("Not evaluating");
+                }
+                return OIIO::ImageBuf(OIIO::ImageSpec(16, 16, 4));
+            }
+
+            void _evalBegin() override
+            {
+                ++evalCount;
+                eval = true;
+            }
+
+            void _evalEnd() override
+            {
+                eval = false;
+            }
+        };
+
+        class ErrorNode : public IImageNode
+        {
+        public:
+            ErrorNode() :
+                IImageNode("ErrorNode")
+            {}
+
+        protected:
+            OIIO::ImageBuf _exec() override
+            {
+                throw std::runtime_error("Error");
+            }
+        };
+    }
+
+    void imageNodeTest()
+    {
+        std::cout << "imageNodeTest" << std::endl;
+        {
+            auto count = std::make_shared<CountNode>();
+            auto a = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ count });
+            auto b = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ count });
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ a, b });
+            const auto buf = comp->exec();
+            assert(1 == count->count);
+            assert(16 == buf.spec().width);
+            comp->exec();
+            assert(2 == count->count);
+        }
+        {
+            auto count = std::make_shared<CountNode>();
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ count, count });
+            comp->exec();
+            assert(1 == count->count);
+            assert(!count->roi.defined());
+        }
+        {
+            auto count = std::make_shared<CountNode>();
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ count });
+            const auto buf = comp->exec(OIIO::ROI(4, 8, 2, 6));
+            assert(16 == buf.spec().width);
+            assert(OIIO::ROI(4, 8, 2, 6) == count->roi);
+        }
+        {
+            // Branches are executed concurrently, each node once.
+            std::vector<std::shared_ptr<CountNode> > counts;
+            std::vector<std::shared_ptr<IImageNode> > nodes;
+            for (int i = 0; i < 8; ++i)
+            {
+                auto count = std::make_shared<CountNode>();
+                counts.push_back(count);
+                nodes.push_back(std::make_shared<CompNode>(
+                    std::vector<std::shared_ptr<IImageNode> >{ count }));
+            }
+            auto shared = std::make_shared<CountNode>();
+            nodes.push_back(shared);
+            nodes.push_back(shared);
+            while (nodes.size() > 1)
+            {
+                std::vector<std::shared_ptr<IImageNode> > comps;
+                for (size_t i = 0; i + 1 < nodes.size(); i += 2)
+                {
+                    comps.push_back(std::make_shared<CompNode>(
+                        std::vector<std::shared_ptr<IImageNode> >{ nodes[i], nodes[i + 1] }));
+                }
+                if (nodes.size() % 2)
+                {
+                    comps.push_back(nodes.back());
+                }
+                nodes = comps;
+            }
+            const auto buf = nodes[0]->exec();
+            assert(16 == buf.spec().width);
+            for (const auto& count : counts)
+            {
+                assert(1 == count->count);
+            }
+            assert(1 == shared->count);
+        }
+        {
+            // Errors in a branch are passed to the caller.
+            auto count = std::make_shared<CountNode>();
+            auto error = std::make_shared<ErrorNode>();
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ count, error });
+            bool thrown = false;
+            try
+            {
+                comp->exec();
+            }
+            catch (const std::exception&)
+            {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        {
+            // Inputs hidden by an opaque image are not executed.
+            auto top = std::make_shared<CountNode>();
+            auto a = std::make_shared<CountNode>();
+            auto b = std::make_shared<CountNode>();
+            auto bottom = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ a, b });
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ top, bottom });
+            comp->exec();
+            assert(1 == top->count);
+            assert(1 == a->count);
+            assert(1 == b->count);
+            assert(!comp->isOpaque());
+
+            top->opaque = true;
+            assert(comp->isOpaque());
+            const auto buf = comp->exec();
+            assert(2 == top->count);
+            assert(1 == a->count);
+            assert(1 == b->count);
+            assert(16 == buf.spec().width);
+
+            ImagePlan plan(comp);
+            assert(2 == plan.getSteps().size());
+            plan.exec();
+            assert(3 == top->count);
+            assert(1 == a->count);
+
+            top->opaque = false;
+            b->opaque = true;
+            assert(comp->isOpaque());
+            comp->exec();
+            assert(2 == a->count);
+            assert(2 == b->count);
+        }
+        {
+            // Each node of the graph begins and ends the evaluation once,
+            // including the inputs that are not needed.
+            auto top = std::make_shared<CountNode>();
+            auto bottom = std::make_shared<CountNode>();
+            top->opaque = true;
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ top, bottom });
+            comp->exec();
+            assert(1 == top->evalCount);
+            assert(1 == bottom->evalCount);
+            assert(0 == bottom->count);
+            assert(!top->eval);
+            assert(!bottom->eval);
+
+            ImagePlan plan(comp);
+            plan.exec();
+            assert(2 == top->evalCount);
+            assert(2 == bottom->evalCount);
+            assert(!top->eval);
+            assert(!bottom->eval);
+
+            // The evaluation also ends when a node fails.
+            auto error = std::make_shared<ErrorNode>();
+            auto errorComp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ top, error });
+            top->opaque = false;
+            bool thrown = false;
+            try
+            {
+                errorComp->exec();
+            }
+            catch (const std::exception&)
+            {
+                thrown = true;
+            }
+            assert(thrown);
+            assert(3 == top->evalCount);
+            assert(!top->eval);
+        }
+    }
+}
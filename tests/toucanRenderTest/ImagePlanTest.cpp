@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "ImagePlanTest.h"
+
+#include <toucanRender/Comp.h>
+#include <toucanRender/Constant.h>
+#include <toucanRender/ImagePlan.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace toucan
+{
+    namespace
+    {
+        class SizeNode : public IImageNode
+        {
+        public:
+            SizeNode(int size) :
+                IImageNode("SizeNode"),
+                _size(size)
+            {}
+
+            int count = 0;
+            bool opaque = false;
+
+            OIIO::ROI getRegionOfDefinition() const override
+            {
+                return OIIO::ROI(0, _size, 0, _size);
+            }
+
+            bool isOpaque() const override
+            {
+                return opaque;
+            }
+
+        protected:
+            OIIO::ImageBuf _exec() override
+            {
+                ++count;
+                return OIIO::ImageBuf(OIIO::ImageSpec(_size, _size, 4));
+            }
+
+        private:
+            int _size = 0;
+        };
+
+        class AllocNode : public IImageNode
+        {
+        public:
+            AllocNode(const std::vector<std::shared_ptr<IImageNode> >& inputs = {}) :
+                IImageNode("AllocNode", inputs)
+            {}
+
+            const void* data = nullptr;
+
+            OIIO::ROI getRegionOfDefinition() const override
+            {
+                return OIIO::ROI(0, 16, 0, 16);
+            }
+
+        protected:
+            OIIO::ImageBuf _exec() override
+            {
+                _execInput(0);
+                OIIO::ImageBuf out = _allocateImage(
+                    OIIO::ImageSpec(16, 16, 4, OIIO::TypeDesc::UINT8));
+                data = out.localpixels();
+                return out;
+            }
+        };
+    }
+
+    void imagePlanTest()
+    {
+        std::cout << "imagePlanTest" << std::endl;
+        {
+            ImagePlan plan(nullptr);
+            assert(plan.getSteps().empty());
+            assert(0 == plan.getBufferCount());
+            assert(0 == plan.getPeakMemory());
+            assert(0 == plan.exec().spec().width);
+        }
+        {
+            // Four layers composited over each other.
+            std::vector<std::shared_ptr<SizeNode> > layers;
+            std::shared_ptr<IImageNode> node;
+            for (int i = 0; i < 4; ++i)
+            {
+                auto layer = std::make_shared<SizeNode>(16);
+                layers.push_back(layer);
+                std::vector<std::shared_ptr<IImageNode> > inputs = { layer };
+                if (node)
+                {
+                    inputs.push_back(node);
+                }
+                node = std::make_shared<CompNode>(inputs);
+            }
+            const OIIO::ImageSpec spec(16, 16, 4, OIIO::TypeDesc::UINT8);
+            ImagePlan plan(node, spec);
+            const auto& steps = plan.getSteps();
+            assert(8 == steps.size());
+            assert(steps.back().node == node);
+
+            // Each step comes after its inputs.
+            for (size_t i = 0; i < steps.size(); ++i)
+            {
+                for (const size_t input : steps[i].inputs)
+                {
+                    assert(input < i);
+                    assert(steps[input].lastUse == i);
+                }
+            }
+
+            // At most three images are live at the same time: the
+            // background, the next layer, and the composite.
+            assert(plan.getBufferCount() <= 3);
+            assert(plan.getPeakMemory() <= 3 * spec.image_bytes());
+
+            const auto buf = plan.exec();
+            assert(16 == buf.spec().width);
+            for (const auto& layer : layers)
+            {
+                assert(1 == layer->count);
+            }
+        }
+        {
+            // Inputs that need more memory are executed first.
+            auto small = std::make_shared<SizeNode>(4);
+            auto large = std::make_shared<SizeNode>(64);
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ small, large });
+            ImagePlan plan(comp, OIIO::ImageSpec(64, 64, 4, OIIO::TypeDesc::UINT8));
+            const auto& steps = plan.getSteps();
+            assert(3 == steps.size());
+            assert(steps[0].node == large);
+            assert(steps[1].node == small);
+        }
+        {
+            // Images are allocated from the buffers of their steps, so
+            // memory is re-used once an image is no longer live.
+            auto a = std::make_shared<AllocNode>();
+            auto b = std::make_shared<AllocNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ a });
+            auto c = std::make_shared<AllocNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ b });
+            auto d = std::make_shared<AllocNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ c });
+            ImagePlan plan(d, OIIO::ImageSpec(16, 16, 4, OIIO::TypeDesc::UINT8));
+            const auto& steps = plan.getSteps();
+            assert(4 == steps.size());
+            assert(steps[0].buffer == steps[2].buffer);
+            assert(steps[0].buffer != steps[1].buffer);
+            plan.exec();
+            assert(a->data);
+            assert(a->data != b->data);
+            assert(a->data == c->data);
+        }
+        {
+            // Images are estimated with the format of the nodes, so the
+            // floating point composite over a constant is not estimated
+            // with the format of the media.
+            const OIIO::ImageSpec spec(16, 16, 4, OIIO::TypeDesc::UINT8);
+            auto fg = std::make_shared<SizeNode>(16);
+            auto bg = std::make_shared<ConstantNode>(
+                IMATH_NAMESPACE::V2i(16, 16),
+                IMATH_NAMESPACE::V4f(1.F, 0.F, 0.F, 1.F));
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            assert(OIIO::TypeDesc::FLOAT == comp->getFormat());
+            ImagePlan plan(comp, spec);
+            const auto& steps = plan.getSteps();
+            assert(2 == steps.size());
+            assert(spec.image_bytes() == steps[0].bytes);
+            assert(4 * spec.image_bytes() == steps[1].bytes);
+            assert(5 * spec.image_bytes() == plan.getPeakMemory());
+            const auto buf = plan.exec();
+            assert(OIIO::TypeDesc::FLOAT == buf.spec().format);
+            assert(steps[1].bytes == buf.spec().image_bytes());
+        }
+        {
+            // The plan is re-built when the inputs that are needed change.
+            auto fg = std::make_shared<SizeNode>(16);
+            auto bg = std::make_shared<SizeNode>(16);
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            ImagePlan plan(comp);
+            assert(3 == plan.getSteps().size());
+            fg->opaque = true;
+            plan.exec();
+            assert(2 == plan.getSteps().size());
+            assert(1 == fg->count);
+            assert(0 == bg->count);
+            fg->opaque = false;
+            plan.exec();
+            assert(3 == plan.getSteps().size());
+            assert(2 == fg->count);
+            assert(1 == bg->count);
+        }
+        {
+            // The size of a hidden background changes the hash, since the
+            // foreground is resized to it.
+            auto fg = std::make_shared<SizeNode>(16);
+            fg->opaque = true;
+            auto bg = std::make_shared<SizeNode>(32);
+            auto bg2 = std::make_shared<SizeNode>(64);
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg });
+            auto comp2 = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ fg, bg2 });
+            comp->setResize(true);
+            comp2->setResize(true);
+            assert(comp->getHash() != comp2->getHash());
+            assert(32 == comp->exec().spec().width);
+            assert(64 == comp2->exec().spec().width);
+            assert(0 == bg->count);
+            assert(0 == bg2->count);
+        }
+    }
+}
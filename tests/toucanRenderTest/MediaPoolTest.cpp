@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "MediaPoolTest.h"
+
+#include <toucanRender/MediaPool.h>
+#include <toucanRender/Read.h>
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+
+namespace toucan
+{
+    void mediaPoolTest(const std::filesystem::path& path)
+    {
+        std::cout << "mediaPoolTest" << std::endl;
+        {
+            auto pool = std::make_shared<MediaPool>();
+            const std::string key = (path / "Letter_A.png").string();
+            const auto create = [path]
+            {
+                return std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            };
+
+            auto read = pool->checkOut(key, create);
+            assert(read);
+            auto stats = pool->getStats();
+            assert(0 == stats.hits);
+            assert(1 == stats.misses);
+            assert(1 == stats.handles);
+            assert(1 == stats.checkedOut);
+            assert(0 == stats.memory);
+
+            // Media that is checked out gets a separate read node.
+            auto read2 = pool->checkOut(key, create);
+            assert(read2);
+            assert(read2 != read);
+            stats = pool->getStats();
+            assert(2 == stats.misses);
+            assert(2 == stats.handles);
+            assert(2 == stats.checkedOut);
+
+            // Checked in read nodes are re-used.
+            pool->checkIn(key, read);
+            pool->checkIn(key, read2);
+            stats = pool->getStats();
+            assert(0 == stats.checkedOut);
+            assert(read->getSpec().image_bytes() * 2 == stats.memory);
+            auto read3 = pool->checkOut(key, create);
+            assert(read3 == read2);
+            stats = pool->getStats();
+            assert(1 == stats.hits);
+            assert(2 == stats.handles);
+            pool->checkIn(key, read3);
+
+            // Idle read nodes are closed when the limits are exceeded.
+            pool->setMaxHandles(1);
+            stats = pool->getStats();
+            assert(1 == stats.evictions);
+            assert(1 == stats.handles);
+            pool->setMaxMemory(0);
+            stats = pool->getStats();
+            assert(2 == stats.evictions);
+            assert(0 == stats.handles);
+            assert(0 == stats.memory);
+        }
+        {
+            // Idle read nodes are closed by key prefix.
+            auto pool = std::make_shared<MediaPool>();
+            const auto create = [path]
+            {
+                return std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            };
+            auto a = pool->checkOut("otioz:1:Letter_A.png", create);
+            auto b = pool->checkOut("otioz:2:Letter_A.png", create);
+            pool->checkIn("otioz:1:Letter_A.png", a);
+            pool->checkIn("otioz:2:Letter_A.png", b);
+            pool->evict("otioz:1:");
+            auto stats = pool->getStats();
+            assert(1 == stats.evictions);
+            assert(1 == stats.handles);
+            assert(pool->checkOut("otioz:2:Letter_A.png", create) == b);
+            assert(pool->checkOut("otioz:1:Letter_A.png", create) != a);
+        }
+        {
+            auto pool = std::make_shared<MediaPool>();
+            try
+            {
+                pool->checkOut(
+                    "error",
+                    []() -> std::shared_ptr<IReadNode>
+                    {
+                        throw std::runtime_error("Cannot open file");
+                    });
+                assert(false);
+            }
+            catch (const std::exception&)
+            {}
+            const auto stats = pool->getStats();
+            assert(1 == stats.misses);
+            assert(0 == stats.handles);
+            assert(0 == stats.checkedOut);
+        }
+    }
+}
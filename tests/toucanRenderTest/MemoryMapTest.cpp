@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright Contributors to the toucan project.
+
+#include "MemoryMapTest.h"
+
+#include <toucanRender/MemoryMap.h>
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace toucan
+{
+    void memoryMapTest()
+    {
+        std::cout << "memoryMapTest" << std::endl;
+        {
+            // Create a local file header with a name and an extra field,
+            // followed by the file data.
+            const std::string name = "media/a.png";
+            const std::string data = "abcd";
+            const size_t extraSize = 8;
+            std::vector<uint8_t> buf(30 + name.size() + extraSize + data.size(), 0);
+            buf[26] = name.size();
+            buf[28] = extraSize;
+            memcpy(buf.data() + 30, name.data(), name.size());
+            memcpy(buf.data() + 30 + name.size() + extraSize, data.data(), data.size());
+
+            MemoryReferences refs(buf.data(), buf.size());
+            assert(refs.empty());
+            refs.add(name, 0, data.size(), false);
+            refs.add("media/b.png", 0, data.size(), true);
+            refs.add("media/c.png", 0, buf.size(), false);
+            assert(!refs.empty());
+
+            const MemoryReferences copy = refs;
+            assert(copy.contains("file://media/a.png"));
+            const MemoryReference mem = copy.find("file://media/a.png");
+            assert(mem.isValid());
+            assert(data.size() == mem.getSize());
+            assert(0 == memcmp(mem.getData(), data.data(), data.size()));
+
+            assert(refs.contains("media/b.png"));
+            assert(!refs.find("media/b.png").isValid());
+            assert(!refs.find("media/c.png").isValid());
+            assert(!refs.contains("media/d.png"));
+            assert(!refs.find("media/d.png").isValid());
+        }
+    }
+}
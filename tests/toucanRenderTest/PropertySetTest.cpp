@@ -6,6 +6,7 @@
 #include <toucanRender/PropertySet.h>
 
 #include <cassert>
+#include <string>
 
 namespace toucan
 {
@@ -110,5 +111,57 @@ namespace toucan
             status = p.reset("i");
             assert(kOfxStatOK == status);
         }
+        {
+            int a[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+            PropertySet p;
+            p.setIntN("i", 8, a);
+            int b[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            p.getIntN("i", 8, b);
+            assert(b[0] == a[0]);
+            assert(b[7] == a[7]);
+            p.setIntN("i", 2, a + 4);
+            OfxStatus status = p.getIntN("i", 8, b);
+            assert(status != kOfxStatOK);
+            p.getIntN("i", 2, b);
+            assert(5 == b[0]);
+            assert(6 == b[1]);
+        }
+        {
+            const std::string a = "name";
+            const std::string b = "name";
+            PropertySet p;
+            p.setInt(a.c_str(), 0, 1);
+            p.setString("s", 0, "s");
+            int i = 0;
+            p.getInt(b.c_str(), 0, &i);
+            assert(1 == i);
+            const std::vector<std::string> names = p.getIntProperties();
+            assert(1 == names.size());
+            assert(a == names[0]);
+            OfxStatus status = p.reset(b.c_str());
+            assert(kOfxStatOK == status);
+            status = p.getInt(a.c_str(), 0, &i);
+            assert(status != kOfxStatOK);
+            char* s = nullptr;
+            p.getString("s", 0, &s);
+            assert(s);
+            assert(std::string("s") == s);
+        }
+        {
+            PropertySet p;
+            p.setString("first", 0, "first");
+            p.setString("s", 0, "s");
+            char* s = nullptr;
+            p.getString("s", 0, &s);
+            for (int i = 0; i < 16; ++i)
+            {
+                const std::string name = "s" + std::to_string(i);
+                p.setString(name.c_str(), 0, name.c_str());
+            }
+            OfxStatus status = p.reset("first");
+            assert(kOfxStatOK == status);
+            assert(s);
+            assert(std::string("s") == s);
+        }
     }
 }
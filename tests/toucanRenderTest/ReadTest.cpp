@@ -3,9 +3,19 @@
 
 #include "ReadTest.h"
 
+#include <toucanRender/Comp.h>
+#include <toucanRender/FFmpegRead.h>
+#include <toucanRender/FFmpegWrite.h>
+#include <toucanRender/ImageArena.h>
+#include <toucanRender/ImagePlan.h>
 #include <toucanRender/Read.h>
 
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imageio.h>
+
 #include <cassert>
+#include <iostream>
+#include <vector>
 
 namespace toucan
 {
@@ -17,5 +27,96 @@ namespace toucan
         auto buf = read->exec();
         const auto& spec = buf.spec();
         assert(spec.width > 0);
+
+        {
+            // Images with a data window that is offset from the origin.
+            OIIO::ImageSpec exrSpec(8, 4, 3, OIIO::TypeDesc::HALF);
+            exrSpec.x = 5;
+            exrSpec.y = 7;
+            exrSpec.full_width = 32;
+            exrSpec.full_height = 32;
+            std::vector<float> pixels(exrSpec.width * exrSpec.height * 3);
+            for (int y = 0; y < exrSpec.height; ++y)
+            {
+                for (int x = 0; x < exrSpec.width * 3; ++x)
+                {
+                    pixels[y * exrSpec.width * 3 + x] = static_cast<float>(y);
+                }
+            }
+            const std::filesystem::path exrPath =
+                std::filesystem::temp_directory_path() / "toucanReadTest.exr";
+            {
+                auto output = OIIO::ImageOutput::create(exrPath.string());
+                assert(output);
+                const bool opened = output->open(exrPath.string(), exrSpec);
+                assert(opened);
+                const bool written = output->write_image(OIIO::TypeDesc::FLOAT, pixels.data());
+                assert(written);
+                output->close();
+            }
+            auto exr = std::make_shared<ImageReadNode>(exrPath);
+            const auto exrBuf = exr->exec();
+            assert(exrSpec.width == exrBuf.spec().width);
+            assert(exrSpec.height == exrBuf.spec().height);
+            for (int y = 0; y < exrSpec.height; ++y)
+            {
+                float pixel[4] = { 0.F, 0.F, 0.F, 0.F };
+                exrBuf.getpixel(0, y, pixel);
+                assert(static_cast<float>(y) == pixel[0]);
+                assert(1.F == pixel[3]);
+            }
+
+            // Only the rows in the region of interest are read.
+            const auto exrROIBuf = exr->exec(OIIO::ROI(0, 8, 2, 4));
+            float pixel[4] = { 0.F, 0.F, 0.F, 0.F };
+            exrROIBuf.getpixel(0, 3, pixel);
+            assert(3.F == pixel[0]);
+            exr.reset();
+            std::filesystem::remove(exrPath);
+        }
+        {
+            // Movies without an alpha channel are opaque, so they hide
+            // the inputs below them in a composite.
+            auto image = std::make_shared<ImageReadNode>(path / "Letter_A.png");
+            const OIIO::ImageSpec& imageSpec = image->getSpec();
+            const std::filesystem::path moviePath =
+                std::filesystem::temp_directory_path() / "toucanReadTest.mov";
+            const OTIO_NS::TimeRange timeRange(
+                OTIO_NS::RationalTime(0.0, 24.0),
+                OTIO_NS::RationalTime(2.0, 24.0));
+            {
+                const OIIO::ImageSpec movieSpec(imageSpec.width, imageSpec.height, 3);
+                ffmpeg::Write write(moviePath, movieSpec, timeRange, ffmpeg::VideoCodec::MJPEG);
+                const float gray[] = { .5F, .5F, .5F };
+                const OIIO::ImageBuf frame = OIIO::ImageBufAlgo::fill(gray, movieSpec.roi());
+                write.writeImage(frame, OTIO_NS::RationalTime(0.0, 24.0));
+                write.writeImage(frame, OTIO_NS::RationalTime(1.0, 24.0));
+            }
+            auto movie = std::make_shared<MovieReadNode>(moviePath);
+            assert(movie->isOpaque());
+            auto comp = std::make_shared<CompNode>(
+                std::vector<std::shared_ptr<IImageNode> >{ movie, image });
+            assert(comp->isOpaque());
+            ImagePlan plan(comp);
+            assert(2 == plan.getSteps().size());
+            const auto compBuf = plan.exec();
+            assert(imageSpec.width == compBuf.spec().width);
+
+            // Movie frames are allocated from the arena, both when they
+            // are decoded on the caller's thread and when they are decoded
+            // ahead.
+            {
+                ImageArena arena;
+                auto ffRead = std::make_shared<ffmpeg::Read>(moviePath);
+                auto frame = ffRead->getImage(OTIO_NS::RationalTime(0.0, 24.0), &arena);
+                assert(arena.owns(frame));
+                ffRead->setReadAhead(2);
+                frame = ffRead->getImage(OTIO_NS::RationalTime(1.0, 24.0), &arena);
+                assert(arena.owns(frame));
+                frame = ffRead->getImage(OTIO_NS::RationalTime(0.0, 24.0));
+                assert(OIIO::ImageBuf::LOCALBUFFER == frame.storage());
+            }
+            std::filesystem::remove(moviePath);
+        }
     }
 }